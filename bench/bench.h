@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+// A tiny self-registering benchmark harness, in the spirit of boost::ut suites:
+//
+//  bench::registrar _{"group", []{ ... bench::report(name, ops, elapsed); }};
+//
+// The benchmark binary runs every registered group whose name contains the
+// filter argument. `--json` prints one JSON object per result instead of the
+// table, `--pin` lets benchmarks pin their threads through pin_thread().
+namespace bench {
+
+using clock = std::chrono::steady_clock;
+
+struct options_t {
+    std::string_view filter{};
+    std::string_view group{};   // group currently running
+    bool             json{false};
+    bool             pin{false};
+};
+
+inline options_t& options() {
+    static options_t opts{};
+    return opts;
+}
+
+// Pins the calling thread to cpu `index` modulo the cpu count, only with --pin
+inline void pin_thread(size_t index) {
+    if (!options().pin) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % std::max(std::thread::hardware_concurrency(), 1u), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Latency samples in nanoseconds. Benchmarks keep one per thread, merge
+// them after joining and hand the result to report().
+class latency {
+public:
+    void add(clock::duration d) {
+        this->samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    void merge(const latency& other) {
+        this->samples.insert(this->samples.end(), other.samples.begin(), other.samples.end());
+    }
+
+    bool empty() const { return this->samples.empty(); }
+
+    // p in [0, 1]
+    uint64_t percentile(double p) {
+        if (this->samples.empty()) {
+            return 0;
+        }
+        std::ranges::sort(this->samples);
+        size_t idx = static_cast<size_t>(p * static_cast<double>(this->samples.size() - 1));
+        return this->samples[idx];
+    }
+
+private:
+    std::vector<uint64_t> samples{};
+};
+
+struct case_t {
+    std::string_view      name;
+    std::function<void()> run;
+};
+
+inline std::vector<case_t>& cases() {
+    static std::vector<case_t> cases{};
+    return cases;
+}
+
+struct registrar {
+    registrar(std::string_view name, std::function<void()> run) {
+        cases().push_back({name, std::move(run)});
+    }
+};
+
+inline void report(std::string_view name, size_t ops, clock::duration elapsed, latency* lat = nullptr) {
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    bool has_lat = lat && !lat->empty();
+    if (options().json) {
+        std::print(R"({{"group":"{}","name":"{}","ops":{},"ns_per_op":{:.3f},"mops":{:.3f})",
+            options().group, name, ops, ns / ops, ops / ns * 1e3);
+        if (has_lat) {
+            std::print(R"(,"p50_ns":{},"p90_ns":{},"p99_ns":{},"p999_ns":{},"max_ns":{})",
+                lat->percentile(0.5), lat->percentile(0.9), lat->percentile(0.99),
+                lat->percentile(0.999), lat->percentile(1.0));
+        }
+        std::println("}}");
+        return;
+    }
+    std::print("{:<56} {:>12} ops {:>10.2f} ns/op {:>10.2f} Mops/s",
+        name, ops, ns / ops, ops / ns * 1e3);
+    if (has_lat) {
+        std::print("  p50 {} p99 {} p999 {} ns",
+            lat->percentile(0.5), lat->percentile(0.99), lat->percentile(0.999));
+    }
+    std::println("");
+}
+
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
@@ -0,0 +1,115 @@
+#include <array>
+#include <atomic>
+#include <format>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpsc_queue.h"
+#include "concurrent/mpsc_ringbuffer.h"
+
+namespace {
+
+template<typename queue_t>
+void push(queue_t& q, std::span<const size_t> items) {
+    if constexpr (requires { { q.emplace_back_bulk(items) } -> std::same_as<size_t>; }) {
+        // bounded, retry whatever did not fit
+        while (!items.empty()) {
+            size_t n = q.emplace_back_bulk(items);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            items = items.subspan(n);
+        }
+    } else {
+        q.emplace_back_bulk(items);
+    }
+}
+
+template<typename queue_t>
+void push_one(queue_t& q, size_t item) {
+    if constexpr (requires { { q.emplace_back(item) } -> std::same_as<bool>; }) {
+        while (!q.emplace_back(item)) {
+            std::this_thread::yield();
+        }
+    } else {
+        q.emplace_back(item);
+    }
+}
+
+// per-element cost with producers pushing and consumers popping
+// `batch` elements per call, batch 1 uses the single element API
+template<typename queue_t, size_t batch>
+void run(std::string_view name, size_t producers, size_t consumers, size_t per_producer) {
+    auto q = std::make_unique<queue_t>();
+    const size_t total = producers * per_producer;
+    std::atomic<bool> go{false};
+    std::atomic<size_t> consumed{0};
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            std::array<size_t, batch> items{};
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_producer; i += batch) {
+                if constexpr (batch == 1) {
+                    push_one(*q, i);
+                } else {
+                    items.fill(i);
+                    push(*q, std::span<const size_t>(items).first(std::min(batch, per_producer - i)));
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::array<size_t, batch> out{};
+            while (!go.load(std::memory_order_acquire)) {}
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                size_t n = 0;
+                if constexpr (batch == 1) {
+                    if (auto v = q->pop_front(); v) {
+                        out[0] = *v;
+                        n = 1;
+                    }
+                } else {
+                    n = q->pop_bulk(out.begin(), batch);
+                }
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                bench::do_not_optimize(out);
+                consumed.fetch_add(n, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto start = bench::clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) {
+        th.join();
+    }
+    bench::report(
+        std::format("{} batch {} {}p/{}c", name, batch, producers, consumers),
+        total, bench::clock::now() - start
+    );
+}
+
+template<size_t batch>
+void run_all() {
+    constexpr size_t per_producer = 1'000'000;
+    run<concurrent::mpsc_queue<size_t>, batch>("mpsc_queue", 4, 1, per_producer);
+    run<concurrent::mpsc_ringbuffer<size_t, 1024>, batch>("mpsc_ringbuffer<1024>", 4, 1, per_producer);
+    run<concurrent::mpmc_queue<size_t>, batch>("mpmc_queue", 4, 4, per_producer);
+}
+
+bench::registrar _{"bulk push/pop", [] {
+    run_all<1>();
+    run_all<8>();
+    run_all<64>();
+}};
+
+}
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <format>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent/ebr.h"
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpmc_ringbuffer.h"
+
+namespace {
+
+template<typename queue_t>
+void run(std::string_view name, size_t producers, size_t consumers, size_t per_producer) {
+    auto q = std::make_unique<queue_t>();
+    const size_t total = producers * per_producer;
+    std::atomic<bool> go{false};
+    std::atomic<size_t> consumed{0};
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_producer; ++i) {
+                q->emplace_back(i);
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {}
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (auto v = q->pop_front(); v) {
+                    bench::do_not_optimize(*v);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    auto start = bench::clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) {
+        th.join();
+    }
+    bench::report(
+        std::format("{} {}p/{}c", name, producers, consumers),
+        total, bench::clock::now() - start
+    );
+}
+
+bench::registrar _{"mpmc queue vs vyukov ring", [] {
+    constexpr size_t per_producer = 1'000'000;
+    for (auto [p, c] : {std::pair{1uz, 1uz}, {2uz, 2uz}, {4uz, 4uz}, {8uz, 8uz}, {1uz, 8uz}, {8uz, 1uz}}) {
+        run<concurrent::mpmc_queue<size_t>>("mpmc_queue", p, c, per_producer);
+        run<concurrent::mpmc_queue<size_t, 64, concurrent::epoch_manager>>("mpmc_queue<ebr>", p, c, per_producer);
+        run<concurrent::mpmc_ringbuffer<size_t, 1024>>("mpmc_ringbuffer<1024>", p, c, per_producer);
+    }
+}};
+
+}
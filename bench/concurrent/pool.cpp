@@ -0,0 +1,129 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent/mpsc_ringbuffer.h"
+#include "concurrent/object_pool.h"
+#include "concurrent/spsc_object_pool.h"
+
+namespace {
+
+constexpr size_t burst = 64;
+constexpr size_t rounds = 20'000;
+
+template<size_t N>
+struct object_t {
+    std::array<std::byte, N> data;
+};
+
+// Same allocate/deallocate interface for the heap as for the pools
+template<typename T>
+struct heap_t {
+    T* allocate() { return new T; }
+    void deallocate(T* obj) { delete obj; }
+};
+
+template<typename pool_t>
+std::unique_ptr<pool_t> make_pool() {
+    if constexpr (std::is_constructible_v<pool_t, size_t>) {
+        return std::make_unique<pool_t>(4096);
+    } else {
+        return std::make_unique<pool_t>();
+    }
+}
+
+// Allocates a burst and frees it again on the same thread, every burst
+// samples the latency of one allocate()
+template<typename pool_t>
+void same_thread(std::string_view name) {
+    auto pool = make_pool<pool_t>();
+    std::array<decltype(pool->allocate()), burst> objs{};
+    bench::latency lat;
+    bench::pin_thread(0);
+
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        auto t = bench::clock::now();
+        objs[0] = pool->allocate();
+        lat.add(bench::clock::now() - t);
+        for (size_t i = 1; i < burst; ++i) {
+            objs[i] = pool->allocate();
+        }
+        bench::do_not_optimize(objs);
+        for (auto* obj : objs) {
+            pool->deallocate(obj);
+        }
+    }
+    bench::report(std::format("{} same thread", name), rounds * burst, bench::clock::now() - start, &lat);
+}
+
+// One thread allocates and hands the objects to another one that frees
+// them, the only pattern spsc_object_pool supports
+template<typename pool_t>
+void handoff(std::string_view name) {
+    auto pool = make_pool<pool_t>();
+    using ptr_t = decltype(pool->allocate());
+    auto ring = std::make_unique<concurrent::mpsc_ringbuffer<ptr_t, 1024>>();
+    const size_t total = rounds * burst;
+    std::atomic<bool> go{false};
+    bench::latency lat;
+
+    std::thread consumer([&] {
+        bench::pin_thread(1);
+        while (!go.load(std::memory_order_acquire)) {}
+        for (size_t i = 0; i < total;) {
+            if (auto obj = ring->pop_front(); obj) {
+                pool->deallocate(*obj);
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bench::pin_thread(0);
+    auto start = bench::clock::now();
+    go.store(true, std::memory_order_release);
+    for (size_t i = 0; i < total; ++i) {
+        ptr_t obj;
+        if (i % burst == 0) {
+            auto t = bench::clock::now();
+            obj = pool->allocate();
+            lat.add(bench::clock::now() - t);
+        } else {
+            obj = pool->allocate();
+        }
+        // the bounded pools run dry while the consumer lags behind
+        while (obj == nullptr) {
+            std::this_thread::yield();
+            obj = pool->allocate();
+        }
+        while (!ring->emplace_back(obj)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    bench::report(std::format("{} handoff", name), total, bench::clock::now() - start, &lat);
+}
+
+template<size_t N>
+void run_size() {
+    using T = object_t<N>;
+    same_thread<heap_t<T>>(std::format("new/delete {}B", N));
+    same_thread<concurrent::spsc_object_pool<T>>(std::format("spsc_object_pool {}B", N));
+    same_thread<concurrent::object_pool<T>>(std::format("object_pool {}B", N));
+    handoff<heap_t<T>>(std::format("new/delete {}B", N));
+    handoff<concurrent::spsc_object_pool<T>>(std::format("spsc_object_pool {}B", N));
+    handoff<concurrent::object_pool<T>>(std::format("object_pool {}B", N));
+}
+
+bench::registrar _{"object pools", [] {
+    run_size<64>();
+    run_size<512>();
+}};
+
+}
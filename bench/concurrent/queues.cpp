@@ -0,0 +1,118 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpsc_lanes.h"
+#include "concurrent/mpsc_queue.h"
+#include "concurrent/mpsc_ringbuffer.h"
+
+namespace {
+
+// Every 64th element carries its enqueue time, the consumer turns it into
+// an end-to-end latency sample. Producers run flat out, so for the unbounded
+// queues this is mostly the backlog, the rings bound it by their capacity.
+constexpr size_t sample_every = 64;
+
+template<size_t N>
+struct payload_t {
+    static_assert(N >= sizeof(int64_t));
+    int64_t stamp;
+    std::array<std::byte, N - sizeof(int64_t)> pad;
+};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench::clock::now().time_since_epoch()).count();
+}
+
+template<typename queue_t, typename T>
+void push_one(queue_t& q, const T& item) {
+    if constexpr (requires { { q.emplace_back(item) } -> std::same_as<bool>; }) {
+        while (!q.emplace_back(item)) {
+            std::this_thread::yield();
+        }
+    } else {
+        q.emplace_back(item);
+    }
+}
+
+template<typename queue_t, size_t N>
+void run(std::string_view name, size_t producers, size_t consumers) {
+    using payload = payload_t<N>;
+    const size_t per_producer = 2'000'000 / producers;
+    const size_t total = producers * per_producer;
+    auto q = std::make_unique<queue_t>();
+    std::atomic<bool> go{false};
+    std::atomic<size_t> consumed{0};
+    std::vector<bench::latency> lats(consumers);
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            bench::pin_thread(p);
+            payload item{};
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_producer; ++i) {
+                item.stamp = i % sample_every == 0 ? now_ns() : 0;
+                push_one(*q, item);
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            bench::pin_thread(producers + c);
+            auto& lat = lats[c];
+            while (!go.load(std::memory_order_acquire)) {}
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (auto v = q->pop_front(); v) {
+                    if (v->stamp) {
+                        lat.add(std::chrono::nanoseconds(now_ns() - v->stamp));
+                    }
+                    bench::do_not_optimize(*v);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    auto start = bench::clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) {
+        th.join();
+    }
+    auto elapsed = bench::clock::now() - start;
+    for (size_t c = 1; c < consumers; ++c) {
+        lats[0].merge(lats[c]);
+    }
+    bench::report(
+        std::format("{} {}B {}p/{}c", name, N, producers, consumers),
+        total, elapsed, &lats[0]
+    );
+}
+
+template<size_t N>
+void run_payload() {
+    for (size_t p : {1uz, 4uz, 8uz}) {
+        run<concurrent::mpsc_queue<payload_t<N>>, N>("mpsc_queue", p, 1);
+        run<concurrent::mpsc_ringbuffer<payload_t<N>, 1024>, N>("mpsc_ringbuffer<1024>", p, 1);
+        run<concurrent::mpsc_lanes<payload_t<N>, 1024>, N>("mpsc_lanes<1024>", p, 1);
+    }
+    for (auto [p, c] : {std::pair{1uz, 1uz}, {4uz, 4uz}, {8uz, 8uz}, {1uz, 8uz}, {8uz, 1uz}}) {
+        run<concurrent::mpmc_queue<payload_t<N>>, N>("mpmc_queue", p, c);
+    }
+}
+
+bench::registrar _{"queue throughput and latency", [] {
+    run_payload<8>();
+    run_payload<64>();
+    run_payload<256>();
+}};
+
+}
@@ -0,0 +1,85 @@
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent/ebr.h"
+#include "concurrent/hp.h"
+
+namespace {
+
+constexpr size_t per_thread = 1'000'000;
+constexpr size_t sample_every = 64;
+
+struct node_t {
+    size_t value;
+};
+
+// Runs `body(reclaimer, i, lat)` per_thread times on each thread
+template<typename reclaimer_t, typename body_t>
+void run(std::string_view name, size_t threads, body_t body) {
+    auto reclaimer = std::make_unique<reclaimer_t>();
+    std::atomic<bool> go{false};
+    std::vector<bench::latency> lats(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            bench::pin_thread(t);
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_thread; ++i) {
+                body(*reclaimer, i, lats[t]);
+            }
+        });
+    }
+    auto start = bench::clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : workers) {
+        th.join();
+    }
+    auto elapsed = bench::clock::now() - start;
+    for (size_t t = 1; t < threads; ++t) {
+        lats[0].merge(lats[t]);
+    }
+    bench::report(std::format("{} {}t", name, threads), threads * per_thread, elapsed, &lats[0]);
+}
+
+// protect + clear around a read, the cost every queue operation pays
+template<typename reclaimer_t>
+void protect(std::string_view name, size_t threads) {
+    node_t shared{42};
+    run<reclaimer_t>(name, threads, [&](reclaimer_t& r, size_t, bench::latency&) {
+        r.template protect<0>(&shared);
+        bench::do_not_optimize(shared.value);
+        r.template clear<0>();
+    });
+}
+
+// retire of fresh nodes, the sampled latency shows the scans
+template<typename reclaimer_t>
+void retire(std::string_view name, size_t threads) {
+    run<reclaimer_t>(name, threads, [](reclaimer_t& r, size_t i, bench::latency& lat) {
+        auto* node = new node_t{i};
+        if (i % sample_every == 0) {
+            auto t = bench::clock::now();
+            r.retire(node);
+            lat.add(bench::clock::now() - t);
+        } else {
+            r.retire(node);
+        }
+    });
+}
+
+bench::registrar _{"reclamation", [] {
+    for (size_t t : {1uz, 2uz, 4uz, 8uz}) {
+        protect<concurrent::hazard_manager>("hazard_manager protect/clear", t);
+        protect<concurrent::epoch_manager>("epoch_manager protect/clear", t);
+    }
+    for (size_t t : {1uz, 2uz, 4uz, 8uz}) {
+        retire<concurrent::hazard_manager>("hazard_manager retire", t);
+        retire<concurrent::epoch_manager>("epoch_manager retire", t);
+    }
+}};
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <charconv>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include "coro/sendable_task.h"
+#include "http/request.h"
+#include "http/scan.h"
+
+// The request parser as it was before the state machine: a sendable_task
+// coroutine per parser and a std::queue of messages. Kept as the baseline
+// of the parser benchmark, line parsing is shared with the real parser so
+// only the driving machinery differs. It does not pin messages across
+// feeds, the benchmark input stays alive, which flatters it a little.
+namespace bench::legacy {
+
+class coro_parser {
+public:
+    using parse_task = coro::sendable_task<void, std::string_view>;
+
+    void feed(std::string_view data) {
+        this->t.send_and_resume(data);
+    }
+
+    bool empty() const {
+        return this->msg_queue.empty();
+    }
+
+    std::optional<http::request::msg> pop_front() {
+        auto ret = std::move(this->msg_queue.front());
+        this->msg_queue.pop();
+        return ret;
+    }
+
+private:
+    void fail_parse() {
+        this->msg_queue.push(std::nullopt);
+        this->line_buffer.clear();
+        this->data_view = std::string_view{};
+    }
+
+    std::optional<std::string_view> get_line(http::request::msg& request) {
+        if (auto line_end = http::scan::find_crlf(this->data_view); line_end != std::string_view::npos) {
+            auto line_view = this->data_view.substr(0, line_end);
+            this->data_view.remove_prefix(line_end + 2);
+            if (!this->line_buffer.empty()) {
+                this->line_buffer.append(line_view);
+                line_view = request.keep(this->line_buffer);
+                this->line_buffer.clear();
+            }
+            return line_view;
+        }
+        this->line_buffer.append(this->data_view);
+        this->data_view = std::string_view{};
+        return std::nullopt;
+    }
+
+    static parse_task task(coro_parser* instance) {
+        using wait_message = parse_task::wait_message;
+        instance->data_view = co_await wait_message{};
+        while (true) {
+            start_over:
+            http::request::msg request{};
+
+            std::optional<std::string_view> line_opt{};
+            while (!(line_opt = instance->get_line(request))) {
+                instance->data_view = co_await wait_message{};
+            }
+            if (!http::request::detail::parse_request_line(*line_opt, request.line)) {
+                instance->fail_parse();
+                goto start_over;
+            }
+
+            while (true) {
+                while (!(line_opt = instance->get_line(request))) {
+                    instance->data_view = co_await wait_message{};
+                }
+                if (line_opt->empty()) {
+                    break;
+                }
+                if (!http::request::detail::parse_header_line(*line_opt, request.header)) {
+                    instance->fail_parse();
+                    goto start_over;
+                }
+            }
+
+            if (auto it = request.header.find("Content-Length"); it != request.header.end()) {
+                size_t content_length{};
+                auto [ptr, ec] = std::from_chars(it->value.data(), it->value.data() + it->value.size(), content_length);
+                if (ec != std::errc{}) {
+                    instance->fail_parse();
+                    goto start_over;
+                }
+                if (content_length <= instance->data_view.size()) {
+                    request.body = instance->data_view.substr(0, content_length);
+                    instance->data_view.remove_prefix(content_length);
+                } else {
+                    char* body = request.allocate(content_length);
+                    size_t received = 0;
+                    while (received < content_length) {
+                        auto chunk = instance->data_view.substr(0, content_length - received);
+                        chunk.copy(body + received, chunk.size());
+                        received += chunk.size();
+                        instance->data_view.remove_prefix(chunk.size());
+                        if (received < content_length) {
+                            instance->data_view = co_await wait_message{};
+                        }
+                    }
+                    request.body = {body, content_length};
+                }
+            }
+            instance->msg_queue.push(std::move(request));
+        }
+    }
+
+    std::string                                     line_buffer{};
+    std::string_view                                data_view{};
+    parse_task                                      t{task(this)};
+    std::queue<std::optional<http::request::msg>>   msg_queue{};
+};
+
+} // namespace bench::legacy
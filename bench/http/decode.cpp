@@ -0,0 +1,60 @@
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include "bench.h"
+#include "http/http.h"
+#include "http/scan.h"
+
+namespace {
+
+constexpr size_t rounds = 1'000'000;
+
+constexpr std::string_view plain_path = "/static/assets/js/vendor/application.min.js";
+constexpr std::string_view escaped_path = "/files/%E6%96%87%E6%A1%A3/annual%20report%202024.pdf";
+constexpr std::string_view query = "q=http+parser&lang=en&page=3&sort=relevance&filter=type%3Apdf&utm_source=newsletter";
+
+// The iterator overload, which builds a string char by char whatever it gets
+void decode_to_string(std::string_view name, std::string_view str) {
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        std::error_code ec;
+        auto decoded = http::pct_decode(str.begin(), str.end(), ec);
+        bench::do_not_optimize(decoded);
+    }
+    bench::report(name, rounds, bench::clock::now() - start);
+}
+
+void decode_to_view(std::string_view name, std::string_view str) {
+    std::string buffer;
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        std::error_code ec;
+        auto decoded = http::pct_decode(str, buffer, ec);
+        bench::do_not_optimize(decoded);
+    }
+    bench::report(name, rounds, bench::clock::now() - start);
+}
+
+void lookup(std::string_view name, std::string_view key) {
+    std::string buffer;
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        auto value = http::query_params{query}.get(key, buffer);
+        bench::do_not_optimize(value);
+    }
+    bench::report(name, rounds, bench::clock::now() - start);
+}
+
+bench::registrar _{"http decoding", [] {
+    decode_to_string("plain path, to string", plain_path);
+    decode_to_view("plain path, to view", plain_path);
+    decode_to_string("escaped path, to string", escaped_path);
+    decode_to_view("escaped path, to view", escaped_path);
+    lookup("query lookup, first key", "q");
+    lookup("query lookup, escaped value", "filter");
+    lookup("query lookup, missing key", "missing");
+}};
+
+}
@@ -0,0 +1,52 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "bench.h"
+#include "http/multipart.h"
+
+namespace {
+
+constexpr size_t rounds = 200;
+constexpr std::string_view boundary = "----WebKitFormBoundary7MA4YWxkTrZu0gW";
+
+// A 1 MiB file part, with line breaks like a text upload has
+std::string make_body() {
+    std::string file;
+    for (size_t i = 0; file.size() < 1024 * 1024; ++i) {
+        file += "some line of an uploaded text file, number ";
+        file += std::to_string(i);
+        file += "\r\n";
+    }
+    return "--" + std::string{boundary} + "\r\n"
+        "Content-Disposition: form-data; name=\"file\"; filename=\"upload.txt\"\r\n"
+        "Content-Type: text/plain\r\n"
+        "\r\n" + file + "\r\n"
+        "--" + std::string{boundary} + "--\r\n";
+}
+
+// The body fed in `piece` byte reads, as it comes off the socket
+void parse(std::string_view name, const std::string& body, size_t piece) {
+    using parser = http::multipart::parser;
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        parser parser{boundary};
+        size_t size = 0;
+        for (size_t i = 0; i < body.size(); i += piece) {
+            std::string_view input = std::string_view{body}.substr(i, piece);
+            while (!input.empty()) {
+                auto [kind, data] = parser.next(input);
+                size += data.size();
+            }
+        }
+        bench::do_not_optimize(size);
+    }
+    bench::report(name, rounds, bench::clock::now() - start);
+}
+
+bench::registrar _{"http multipart", [] {
+    auto body = make_body();
+    parse("1 MiB part, 8 KiB reads", body, 8192);
+    parse("1 MiB part, 1 KiB reads", body, 1024);
+}};
+
+}
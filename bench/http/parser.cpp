@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "bench.h"
+#include "http/coro_parser.h"
+#include "http/corpus.h"
+#include "http/request.h"
+#include "http/scan.h"
+
+namespace {
+
+constexpr size_t rounds = 200'000;
+
+constexpr std::string_view isa_name(http::scan::isa level) {
+    switch (level) {
+        case http::scan::isa::avx2:  return "avx2";
+        case http::scan::isa::sse42: return "sse4.2";
+        default:                     return "scalar";
+    }
+}
+
+enum class lifetime {
+    connection,     // one parser for the whole stream
+    per_request,    // a new parser for every request, as the old loop did
+    reset,          // one parser, reset() between requests
+};
+
+// Feeds `raw` in pieces of at most `piece` bytes, `rounds` times over
+template<typename parser_t = http::request::parser>
+void parse(std::string_view name, std::string_view raw, size_t per_feed, size_t piece,
+           lifetime mode = lifetime::connection) {
+    auto parser = std::make_unique<parser_t>();
+    size_t parsed = 0;
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds / per_feed; ++r) {
+        if (mode == lifetime::per_request) {
+            parser = std::make_unique<parser_t>();
+        } else if constexpr (requires { parser->reset(); }) {
+            if (mode == lifetime::reset) {
+                parser->reset();
+            }
+        }
+        for (size_t i = 0; i < raw.size(); i += piece) {
+            parser->feed(raw.substr(i, piece));
+        }
+        while (!parser->empty()) {
+            auto msg = parser->pop_front();
+            bench::do_not_optimize(msg);
+            ++parsed;
+        }
+    }
+    bench::report(name, parsed, bench::clock::now() - start);
+}
+
+// The kernels alone over the header block of a browser request
+void kernels(std::string_view level) {
+    constexpr http::scan::char_set tchar{
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!#$%&'*+-.^_`|~"
+    };
+    std::string_view raw = bench::corpus::browser_get;
+    size_t lines = 0;
+    auto start = bench::clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        std::string_view rest = raw;
+        while (true) {
+            auto end = http::scan::find_crlf(rest);
+            if (end == std::string_view::npos || end == 0) {
+                break;
+            }
+            auto name = http::scan::span(rest.substr(0, end), tchar);
+            bench::do_not_optimize(name);
+            rest.remove_prefix(end + 2);
+            ++lines;
+        }
+    }
+    bench::report(std::format("crlf + token scan per line {}", level), lines, bench::clock::now() - start);
+}
+
+bench::registrar _{"http parser", [] {
+    for (auto level : {http::scan::isa::scalar, http::scan::isa::sse42, http::scan::isa::avx2}) {
+        if (!http::scan::supported(level)) {
+            continue;
+        }
+        http::scan::use(level);
+        auto name = isa_name(level);
+        kernels(name);
+        for (const auto& [request, raw] : bench::corpus::requests()) {
+            parse(std::format("{} {}B {}", request, raw.size(), name), raw, 1, raw.size());
+            parse(std::format("{} 16 pipelined {}", request, name), bench::corpus::pipelined(raw, 16), 16, SIZE_MAX);
+            parse(std::format("{} in 64B reads {}", request, name), raw, 1, 64);
+        }
+    }
+    http::scan::use(http::scan::best_isa());
+
+    // the coroutine parser this one replaced, same line parsing and kernels
+    for (const auto& [request, raw] : bench::corpus::requests()) {
+        parse<bench::legacy::coro_parser>(std::format("{} coroutine, parser per request", request), raw, 1, raw.size(), lifetime::per_request);
+        parse<bench::legacy::coro_parser>(std::format("{} coroutine, one parser", request), raw, 1, raw.size());
+        parse(std::format("{} state machine, reset per request", request), raw, 1, raw.size(), lifetime::reset);
+        parse(std::format("{} state machine, one parser", request), raw, 1, raw.size());
+        parse<bench::legacy::coro_parser>(std::format("{} coroutine in 64B reads", request), raw, 1, 64);
+        parse(std::format("{} state machine in 64B reads", request), raw, 1, 64);
+    }
+}};
+
+}
@@ -0,0 +1,27 @@
+#include <string_view>
+#include "bench.h"
+
+// benchmark [filter] [--json] [--pin]
+int main(int argc, char** argv){
+    auto& opts = bench::options();
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--json") {
+            opts.json = true;
+        } else if (arg == "--pin") {
+            opts.pin = true;
+        } else {
+            opts.filter = arg;
+        }
+    }
+    for (auto& [name, run] : bench::cases()) {
+        if (name.find(opts.filter) != std::string_view::npos) {
+            opts.group = name;
+            if (!opts.json) {
+                std::println("== {}", name);
+            }
+            run();
+        }
+    }
+    return 0;
+}
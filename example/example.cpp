@@ -7,6 +7,7 @@
 #include <web/routing.h>
 #include <json/json.h>
 #include <coro/thread.h>
+#include <coro/offload.h>
 
 http::response::msg make_success_msg(std::string&& content_type, std::string&& body) {
     return {
@@ -24,12 +25,18 @@ int main(){
     // Register signal handler for graceful shutdown
     web::loop::reg_stop_signal(SIGINT);
 
-    // Initialize the thread pool
-    if (!coro::thread::init(4)) {
+    // Initialize the thread pool, it grows with load between 2 and 16 workers
+    if (!coro::thread::init_elastic({.min_workers = 2, .max_workers = 16})) {
         std::println("Failed to initialize thread pool");
         return 1;
     }
 
+    // Initialize the offload pool for blocking or cpu-heavy work
+    if (!coro::thread::init_offload(2)) {
+        std::println("Failed to initialize offload pool");
+        return 1;
+    }
+
 
     // Configure the logging system
     logging::add_sink(
@@ -78,20 +85,20 @@ int main(){
         );
     });
 
-    // POST route handling JSON body
+    // POST route handling JSON body, parsing runs on the offload pool
     web::routing::post("/submit", [](const http::request::msg& req) -> web::response::task {
-        auto body = req.body;
-
-        auto json = Json::parse(body);
+        auto json = co_await coro::offload{[&] {
+            return Json::parse(req.body);
+        }};
         if (!json) {
-            return web::response::error(http::response::status_code::bad_request);
+            co_return co_await web::response::error(http::response::status_code::bad_request);
         } else {
             auto object = json->as<Json::object>();
             if (!object) {
-                return web::response::error(http::response::status_code::bad_request);
+                co_return co_await web::response::error(http::response::status_code::bad_request);
             }
             object->get().emplace("status", "received");
-            return web::response::msg(
+            co_return co_await web::response::msg(
                 make_success_msg(
                     "application/json", 
                     std::format("{}", object->get())
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include "concurrent/mpmc_ringbuffer.h"
+namespace concurrent::detail {
+
+// Per-queue free-list of drained chunks, capped at CAP entries.
+// Chunks retired by the queue come back here through recycle_retired
+// instead of being deleted, so steady-state traffic does not touch the
+// heap. Retired chunks may be reclaimed after the queue is gone, so the
+// cache is reference counted: one reference for the queue, one for every
+// chunk waiting in a reclaimer.
+template<typename chunk_t, size_t CAP>
+class chunk_cache {
+    static_assert(CAP == 0 || std::has_single_bit(CAP), "CACHED_CHUNKS must be 0 or a power of 2");
+public:
+    static chunk_cache* create() {
+        return new chunk_cache();
+    }
+
+    chunk_t* acquire() {
+        if constexpr (CAP > 0) {
+            if (auto chunk = this->free_list.pop_front(); chunk) {
+                return *chunk;
+            }
+        }
+        return new node_t(this);
+    }
+
+    // Only for chunks nobody else can reach anymore
+    void recycle(chunk_t* chunk) {
+        if constexpr (CAP > 0) {
+            chunk->reset();
+            if (this->free_list.try_emplace_back(chunk)) {
+                return;
+            }
+        }
+        destroy(chunk);
+    }
+
+    // Deleter handed to the reclaimer, pair with retain() before retire()
+    static void recycle_retired(void* ptr) {
+        auto* chunk = static_cast<chunk_t*>(ptr);
+        auto* owner = static_cast<node_t*>(chunk)->owner;
+        owner->recycle(chunk);
+        owner->release();
+    }
+
+    static void destroy(chunk_t* chunk) {
+        delete static_cast<node_t*>(chunk);
+    }
+
+    void retain() {
+        this->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (this->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    chunk_cache(const chunk_cache&) = delete;
+    chunk_cache& operator=(const chunk_cache&) = delete;
+private:
+    struct node_t : chunk_t {
+        explicit node_t(chunk_cache* owner) : owner(owner) {}
+        chunk_cache* owner;
+    };
+
+    struct empty_t {
+        std::optional<chunk_t*> pop_front() { return std::nullopt; }
+    };
+
+    chunk_cache() = default;
+
+    ~chunk_cache() {
+        while (auto chunk = this->free_list.pop_front()) {
+            destroy(*chunk);
+        }
+    }
+
+    std::atomic<size_t> refs{1};
+    std::conditional_t<(CAP > 0), mpmc_ringbuffer<chunk_t*, CAP>, empty_t> free_list{};
+};
+
+}
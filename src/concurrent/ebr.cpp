@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <thread>
+#include "concurrent/ebr.h"
+namespace concurrent {
+
+namespace detail {
+
+epoch_domain& epoch_domain::get_instance(){
+    static epoch_domain instance{};
+    return instance;
+}
+
+epoch_domain::record_t* epoch_domain::acquire_record(){
+    for (auto* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        bool expected = false;
+        if (!record->in_use.load(std::memory_order_relaxed) &&
+            record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+
+    auto* record = new record_t{};
+    record->in_use.store(true, std::memory_order_relaxed);
+    auto* head = records.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+void epoch_domain::release_record(record_t* record, std::vector<retired_ptr_t>& leftovers){
+    record->epoch.store(0, std::memory_order_release);
+    this->try_advance();
+    this->reclaim(leftovers);
+    if (!leftovers.empty()) {
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        this->orphans.insert(this->orphans.end(), leftovers.begin(), leftovers.end());
+        leftovers.clear();
+    }
+    record->in_use.store(false, std::memory_order_release);
+}
+
+bool epoch_domain::try_advance(){
+    uint64_t epoch = global_epoch.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (auto* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        uint64_t local = record->epoch.load(std::memory_order_acquire);
+        if ((local & 1) && (local >> 1) != epoch) {
+            return false; // someone is still pinned in an older epoch
+        }
+    }
+    return global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+void epoch_domain::reclaim(std::vector<retired_ptr_t>& retired_list){
+    // a thread retires in non decreasing epochs, so the expired nodes
+    // are always a prefix of its list
+    uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+    auto expired = std::ranges::find_if(retired_list, [epoch](retired_ptr_t& rp) {
+        return rp.epoch + 2 > epoch;
+    });
+    for (auto it = retired_list.begin(); it != expired; ++it) {
+        it->deleter(it->ptr);
+    }
+    retired_list.erase(retired_list.begin(), expired);
+}
+
+void epoch_domain::reclaim_orphans(){
+    std::unique_lock<std::mutex> lock(orphan_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || this->orphans.empty()) {
+        return;
+    }
+    uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+    auto view = std::ranges::remove_if(
+        this->orphans,
+        [epoch](retired_ptr_t& rp) {
+            if (rp.epoch + 2 <= epoch) {
+                rp.deleter(rp.ptr);
+                return true;
+            }
+            return false;
+        }
+    );
+    this->orphans.erase(view.begin(), view.end());
+}
+
+epoch_domain::~epoch_domain(){
+    // Every thread has exited by now, nothing can be pinned anymore
+    for (auto& [ptr, deleter, _] : this->orphans) {
+        deleter(ptr);
+    }
+    auto* record = records.load(std::memory_order_acquire);
+    while (record) {
+        auto* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+}
+
+
+epoch_manager::tls_t::tls_t()
+    : record(detail::epoch_domain::get_instance().acquire_record()) {}
+
+epoch_manager::tls_t::~tls_t() {
+    detail::epoch_domain::get_instance().release_record(this->record, this->retired_list);
+}
+
+bool epoch_manager::synchronize() {
+    auto& tls = local_tls();
+    if (tls.mask != 0) {
+        return false;
+    }
+    auto& domain = detail::epoch_domain::get_instance();
+    // nodes retired in `epoch` or earlier expire two advances later
+    uint64_t target = domain.current() + 2;
+    while (domain.current() < target) {
+        if (!domain.try_advance()) {
+            std::this_thread::yield();
+        }
+    }
+    domain.reclaim(tls.retired_list);
+    domain.reclaim_orphans();
+    return true;
+}
+
+void epoch_manager::scan_tls_retired(tls_t& tls) {
+    auto& domain = detail::epoch_domain::get_instance();
+    domain.try_advance();
+    domain.reclaim(tls.retired_list);
+    domain.reclaim_orphans();
+}
+
+} // namespace concurrent
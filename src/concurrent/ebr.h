@@ -0,0 +1,171 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+namespace concurrent {
+
+namespace ebr {
+    // retirements between two attempts to advance the epoch
+    constexpr size_t max_retired_count = 64;
+}
+
+
+namespace detail{
+// Global epoch domain shared by every epoch_manager.
+// A thread announces the epoch it observed while it is inside a critical
+// section, the global epoch only advances once every active thread has
+// caught up, and a node retired in epoch `e` is freed once the global
+// epoch reaches `e + 2`.
+class epoch_domain{
+public:
+    struct alignas(64) record_t {
+        std::atomic<uint64_t> epoch{0};      // (observed epoch << 1) | active
+        std::atomic<bool>     in_use{false};
+        record_t*             next{nullptr};
+    };
+
+    struct retired_ptr_t {
+        void* ptr;
+        auto (*deleter)(void*) -> void;
+        uint64_t epoch;
+    };
+
+    static epoch_domain& get_instance();
+
+    uint64_t current() const {
+        return global_epoch.load(std::memory_order_acquire);
+    }
+
+    // Records are never freed, a record released by an exited thread
+    // is reused by the next one.
+    record_t* acquire_record();
+
+    void release_record(record_t* record, std::vector<retired_ptr_t>& leftovers);
+
+    bool try_advance();
+
+    // frees the expired prefix of a thread's retired list
+    void reclaim(std::vector<retired_ptr_t>& retired_list);
+
+    // retired nodes left behind by exited threads
+    void reclaim_orphans();
+
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+private:
+    epoch_domain() = default;
+    ~epoch_domain();
+
+    alignas(64) std::atomic<uint64_t>  global_epoch{0};
+    alignas(64) std::atomic<record_t*> records{nullptr};
+
+    std::mutex                 orphan_mutex{};
+    std::vector<retired_ptr_t> orphans{};
+};
+}
+
+
+// Epoch based reclamation with the same interface as hazard_manager, so the
+// queues can take it as their reclamation policy. protect() only pins the
+// thread into the current epoch, the pointer itself is not published, and
+// the thread stays pinned until every index is cleared.
+// Pinning costs a thread_local access and one locked exchange, unpinning a
+// release store, and protect() calls while pinned only touch a local mask.
+class epoch_manager {
+public:
+    epoch_manager() = default;
+
+    epoch_manager(const epoch_manager&) = delete;
+    epoch_manager& operator=(const epoch_manager&) = delete;
+    epoch_manager(epoch_manager&&) = delete;
+    epoch_manager& operator=(epoch_manager&&) = delete;
+
+    ~epoch_manager() = default;
+
+    template<size_t index>
+        requires (index < 32)
+    void protect(void*){
+        auto& tls = local_tls();
+        if (tls.mask == 0) {
+            pin(tls);
+        }
+        tls.mask |= (1u << index);
+    }
+
+    template<size_t index>
+        requires (index < 32)
+    void clear(){
+        auto& tls = local_tls();
+        if (tls.mask == 0) {
+            return;
+        }
+        tls.mask &= ~(1u << index);
+        if (tls.mask == 0) {
+            unpin(tls);
+        }
+    }
+
+    void clear_all(){
+        auto& tls = local_tls();
+        if (tls.mask != 0) {
+            tls.mask = 0;
+            unpin(tls);
+        }
+    }
+
+    template<typename T>
+    void retire(T* ptr){
+        this->retire(ptr, [](void* p){ delete static_cast<T*>(p); });
+    }
+
+    template<typename T>
+    void retire(T* ptr, auto (*deleter)(void*) -> void){
+        auto& tls = local_tls();
+        tls.retired_list.emplace_back(
+            static_cast<void*>(ptr), deleter, detail::epoch_domain::get_instance().current()
+        );
+        if (++tls.retire_count % ebr::max_retired_count == 0) {
+            scan_tls_retired(tls);
+        }
+    }
+
+    // Waits out a grace period, then frees what this thread retired before
+    // the call along with the expired orphans. Returns false without
+    // waiting if the calling thread is pinned, it would wait for itself.
+    bool synchronize();
+
+private:
+    using record_t = detail::epoch_domain::record_t;
+    using retired_ptr_t = detail::epoch_domain::retired_ptr_t;
+
+    struct tls_t {
+        tls_t();
+        ~tls_t();
+        record_t*                  record;
+        uint32_t                   mask{0};
+        size_t                     retire_count{0};
+        std::vector<retired_ptr_t> retired_list{};
+    };
+
+    static tls_t& local_tls() {
+        static thread_local tls_t tls{};
+        return tls;
+    }
+
+    static void pin(tls_t& tls) {
+        auto epoch = detail::epoch_domain::get_instance().current();
+        // the announcement must be visible before any shared pointer is read,
+        // a locked exchange is cheaper than store + mfence on x86
+        tls.record->epoch.exchange((epoch << 1) | 1, std::memory_order_seq_cst);
+    }
+
+    static void unpin(tls_t& tls) {
+        tls.record->epoch.store(0, std::memory_order_release);
+    }
+
+    static void scan_tls_retired(tls_t& tls);
+};
+
+} // namespace concurrent
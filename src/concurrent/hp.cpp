@@ -9,13 +9,24 @@ namespace detail {
 
 
 hazard_recorder::record_t* hazard_recorder::allocate_record(){
-    for (auto& record : records) {
-        bool expected = false;
-        if (record.active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
-            return &record;
+    for (auto* block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+        for (auto& record : block->records) {
+            bool expected = false;
+            if (!record.active.load(std::memory_order_relaxed) &&
+                record.active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &record;
+            }
         }
     }
-    return nullptr; 
+
+    // every record is taken, grow by one block and keep its first record
+    auto* block = new record_block_t{};
+    block->records[0].active.store(true, std::memory_order_relaxed);
+    auto* head = blocks.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!blocks.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+    return &block->records[0];
 }
 
 
@@ -26,22 +37,28 @@ void hazard_recorder::collect_unretired(std::vector<retired_ptr_t>& retireds){
     std::lock_guard<std::mutex> lock(g_retired_mutex);
     this->g_retired.insert(this->g_retired.end(), retireds.begin(), retireds.end());
     if (g_retired.size() > hp::max_retired_count) {
-        this->scan_retired(g_retired);
+        this->scan_retired(g_retired, g_hazards);
     }
     
 }
 
-void hazard_recorder::scan_retired(std::vector<retired_ptr_t>& retired_list){
-
-    auto hps = records
-        | std::views::filter([](record_t& rec) {
-            return rec.active.load(std::memory_order_acquire);
-        })
-        | std::views::transform([](record_t& rec) -> std::array<std::atomic<void*>, hp::max_hazard_count>& {
-            return rec.hps;
-        })
-        | std::views::join;
-    
+void hazard_recorder::scan_retired(std::vector<retired_ptr_t>& retired_list, std::vector<void*>& hps){
+    // snapshot the published hazards once, then test each retired pointer
+    // against the sorted snapshot
+    hps.clear();
+    for (auto* block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+        for (auto& record : block->records) {
+            if (!record.active.load(std::memory_order_acquire)) {
+                continue;
+            }
+            for (auto& hazard : record.hps) {
+                if (void* ptr = hazard.load(std::memory_order_acquire); ptr) {
+                    hps.push_back(ptr);
+                }
+            }
+        }
+    }
+    std::ranges::sort(hps);
 
     auto view = std::ranges::remove_if(
         retired_list, 
@@ -49,9 +66,7 @@ void hazard_recorder::scan_retired(std::vector<retired_ptr_t>& retired_list){
 
 
             auto& [ptr, deleter] = rp;
-            if (std::ranges::any_of(hps, [&ptr](std::atomic<void*>& hazard) {
-                    return hazard.load(std::memory_order_acquire) == ptr;
-                })) {
+            if (std::ranges::binary_search(hps, ptr)) {
                 // If the retired pointer is still in use, we need to keep it
                 return false;
             }
@@ -71,17 +86,28 @@ void hazard_recorder::scan_retired(std::vector<retired_ptr_t>& retired_list){
 hazard_recorder::~hazard_recorder() {
     std::lock_guard<std::mutex> lock(g_retired_mutex);
 
-    this->scan_retired(g_retired);
+    this->scan_retired(g_retired, g_hazards);
     if (g_retired.size() > 0) {
         logging::sync::error("Hazard manager still has {} retired pointers after destruction.", g_retired.size());
-        for (const auto& [index, record] : std::views::enumerate(this->records)) {
-            if (record.active.load(std::memory_order_acquire)) {
-                logging::sync::error("Hazard record {} is still active.", index);
+        size_t index = 0;
+        for (auto* block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+            for (auto& record : block->records) {
+                if (record.active.load(std::memory_order_acquire)) {
+                    logging::sync::error("Hazard record {} is still active.", index);
+                }
+                ++index;
             }
         }
 
         std::terminate();
     }
+
+    auto* block = blocks.load(std::memory_order_acquire);
+    while (block) {
+        auto* next = block->next;
+        delete block;
+        block = next;
+    }
 }
 
 }
@@ -92,7 +118,7 @@ hazard_recorder::~hazard_recorder() {
 
 hazard_manager::tls_t::~tls_t() {
     for (auto& [recorder, data] : this->map) {
-        recorder->scan_retired(data.retired_list);
+        recorder->scan_retired(data.retired_list, data.hazards);
         if(data.retired_list.size() > 0) {
             recorder->collect_unretired(data.retired_list);
         }
@@ -109,7 +135,6 @@ hazard_manager::tls_data_t& hazard_manager::local_tls() {
         return it->second;
     } else {
         record_t* record = this->recorder->allocate_record();
-        // here we assume that allocate_record never returns nullptr
         return tls.map.emplace(
             this->recorder, 
             tls_data_t{record, {}}
@@ -120,9 +145,9 @@ hazard_manager::tls_data_t& hazard_manager::local_tls() {
 
 
 void hazard_manager::scan_tls_retired() {
-    auto& r = local_tls().retired_list;
-    if (r.size() > hp::max_retired_count) {
-        this->recorder->scan_retired(r);
+    auto& tls = local_tls();
+    if (tls.retired_list.size() > hp::max_retired_count) {
+        this->recorder->scan_retired(tls.retired_list, tls.hazards);
     }
 }
 
@@ -11,7 +11,7 @@ namespace concurrent {
     
 namespace hp {
     constexpr size_t max_hazard_count = 3;
-    constexpr size_t max_thread_count = 64;
+    constexpr size_t records_per_block = 64;
     constexpr size_t max_retired_count = 16;    
 }
 
@@ -27,6 +27,14 @@ public:
         std::atomic<bool> active;
     };
 
+    // Records are handed out from a lock-free list of blocks. A new block
+    // is pushed when every record is taken, blocks are only freed with
+    // the recorder, and records of exited threads are reused.
+    struct record_block_t {
+        std::array<record_t, hp::records_per_block> records{};
+        record_block_t* next{nullptr};
+    };
+
     struct retired_ptr_t {
         void* ptr;
         auto (*deleter)(void*) -> void;
@@ -34,13 +42,16 @@ public:
     record_t* allocate_record();
     void deallocate_record(record_t* record);
 
-    void scan_retired(std::vector<retired_ptr_t>& retired_list);
+    // `hazards` is scratch space kept by the caller, so that scans do not
+    // allocate once it has grown to the number of published hazards
+    void scan_retired(std::vector<retired_ptr_t>& retired_list, std::vector<void*>& hazards);
 
     void collect_unretired(std::vector<retired_ptr_t>& retireds); 
 private:
 
-    std::array<record_t, hp::max_thread_count> records;
+    std::atomic<record_block_t*> blocks{nullptr};
     std::vector<retired_ptr_t> g_retired;
+    std::vector<void*> g_hazards;
     std::mutex g_retired_mutex;
 };
 };
@@ -92,6 +103,7 @@ private:
     struct tls_data_t {
         record_t* record;
         std::vector<retired_ptr_t> retired_list;
+        std::vector<void*> hazards{};
     };
 
     struct tls_t {
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace concurrent {
+
+// Bounded MPMC ring after Dmitry Vyukov's design: every cell carries a
+// sequence number, so producers and consumers only contend on their own
+// position counter and never wait for a half-written neighbour.
+//
+// emplace_back / pop_front have the same shape as mpmc_queue, so it can
+// be used as a drop-in backing queue. emplace_back blocks while the ring
+// is full; try_emplace_back / pop_front never block, pop_front_wait does.
+template <typename T, size_t N = 1024>
+class mpmc_ringbuffer{
+public:
+    static_assert((N & (N - 1)) == 0, "N must be power of 2");
+
+    mpmc_ringbuffer();
+
+    ~mpmc_ringbuffer();
+
+    mpmc_ringbuffer(const mpmc_ringbuffer&) = delete;
+    mpmc_ringbuffer(mpmc_ringbuffer&&) = delete;
+    mpmc_ringbuffer& operator=(const mpmc_ringbuffer&) = delete;
+    mpmc_ringbuffer& operator=(mpmc_ringbuffer&&) = delete;
+
+    static constexpr size_t capacity() { return N; }
+
+    size_t size() const {
+        size_t w = enqueue_pos.load(std::memory_order_acquire);
+        size_t r = dequeue_pos.load(std::memory_order_acquire);
+        return w > r ? w - r : 0;
+    }
+
+    template<typename... args_t>
+    bool try_emplace_back(args_t&&... args);
+
+    template<typename... args_t>
+    void emplace_back(args_t&&... args);
+
+    void push_back(const T& item) { emplace_back(item); }
+
+    void push_back(T&& item) { emplace_back(std::move(item)); }
+
+    std::optional<T> pop_front();
+
+    T pop_front_wait();
+
+private:
+    struct alignas(64) cell_t {
+        std::atomic<size_t> sequence{0};
+        alignas(T) std::byte storage[sizeof(T)]{};
+        T& get() {
+            return *std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    cell_t& get_cell(size_t pos) {
+        return buffer[pos & (N - 1)];
+    }
+
+    // Backs off on the sequence of `cell` until it differs from `seq`,
+    // yielding first and parking on the futex only after that.
+    void wait_cell(cell_t& cell, size_t seq);
+
+    static constexpr size_t yield_rounds = 64;
+
+    void publish(cell_t& cell, size_t seq) {
+        // seq_cst pairs with the seq_cst increment of `waiters` in wait_cell,
+        // so either the waiter sees the new sequence or we see the waiter.
+        cell.sequence.store(seq, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) > 0) {
+            cell.sequence.notify_all();
+        }
+    }
+
+    alignas(64) std::array<cell_t, N> buffer;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+    alignas(64) std::atomic<size_t> waiters{0};
+};
+
+template<typename T, size_t N>
+mpmc_ringbuffer<T, N>::mpmc_ringbuffer(){
+    for (size_t i = 0; i < N; ++i) {
+        buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, size_t N>
+template<typename... args_t>
+bool mpmc_ringbuffer<T, N>::try_emplace_back(args_t&&... args) {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell_t& cell = this->get_cell(pos);
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                // construct new value in place
+                new (&cell.storage) T(std::forward<args_t>(args)...);
+                this->publish(cell, pos + 1);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // buffer is full
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, size_t N>
+template<typename... args_t>
+void mpmc_ringbuffer<T, N>::emplace_back(args_t&&... args) {
+    // args are only consumed by a successful try_emplace_back
+    while (!this->try_emplace_back(std::forward<args_t>(args)...)) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        cell_t& cell = this->get_cell(pos);
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) {
+            this->wait_cell(cell, seq);
+        }
+    }
+}
+
+template<typename T, size_t N>
+std::optional<T> mpmc_ringbuffer<T, N>::pop_front(){
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell_t& cell = this->get_cell(pos);
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                std::optional<T> result{std::move(cell.get())};
+                cell.get().~T();
+                this->publish(cell, pos + N);
+                return result;
+            }
+        } else if (diff < 0) {
+            return std::nullopt; // no elements to pop
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, size_t N>
+T mpmc_ringbuffer<T, N>::pop_front_wait(){
+    while (true) {
+        if (auto result = this->pop_front(); result) {
+            return std::move(*result);
+        }
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        cell_t& cell = this->get_cell(pos);
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            this->wait_cell(cell, seq);
+        }
+    }
+}
+
+template<typename T, size_t N>
+void mpmc_ringbuffer<T, N>::wait_cell(cell_t& cell, size_t seq) {
+    for (size_t i = 0; i < yield_rounds; ++i) {
+        if (cell.sequence.load(std::memory_order_acquire) != seq) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    if (cell.sequence.load(std::memory_order_seq_cst) == seq) {
+        cell.sequence.wait(seq, std::memory_order_acquire);
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template<typename T, size_t N>
+mpmc_ringbuffer<T, N>::~mpmc_ringbuffer(){
+    size_t r = dequeue_pos.load(std::memory_order_acquire);
+    size_t w = enqueue_pos.load(std::memory_order_acquire);
+    for (size_t i = r; i < w; ++i) {
+        auto& cell = this->get_cell(i);
+        if (cell.sequence.load(std::memory_order_acquire) == i + 1) {
+            cell.get().~T();
+        }
+    }
+}
+
+}
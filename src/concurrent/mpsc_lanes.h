@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace concurrent {
+
+namespace detail {
+
+// Bounded single producer single consumer ring, both sides keep a cached
+// copy of the other side's index and only reload it when the cache says
+// full (producer) or empty (consumer).
+template<typename T, size_t N>
+struct spsc_lane {
+    static_assert((N & (N - 1)) == 0, "N must be power of 2");
+
+    struct alignas(alignof(T)) storage_t {
+        std::byte data[sizeof(T)];
+        T& get() {
+            return *std::launder(reinterpret_cast<T*>(this->data));
+        }
+    };
+
+    template<typename... args_t>
+    bool try_emplace_back(args_t&&... args) {
+        size_t t = this->tail.load(std::memory_order_relaxed);
+        if (t - this->cached_head >= N) {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            if (t - this->cached_head >= N) {
+                return false;
+            }
+        }
+        new (this->slots[t & (N - 1)].data) T(std::forward<args_t>(args)...);
+        this->tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop_front() {
+        size_t h = this->head.load(std::memory_order_relaxed);
+        if (h == this->cached_tail) {
+            this->cached_tail = this->tail.load(std::memory_order_acquire);
+            if (h == this->cached_tail) {
+                return std::nullopt;
+            }
+        }
+        auto& slot = this->slots[h & (N - 1)].get();
+        std::optional<T> result{std::move(slot)};
+        slot.~T();
+        this->head.store(h + 1, std::memory_order_release);
+        return result;
+    }
+
+    size_t size() const {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+
+    // consumer side
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cached_tail{0};
+    // producer side
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cached_head{0};
+
+    alignas(64) std::atomic<bool> in_use{true};
+    spsc_lane* next{nullptr};
+    std::array<storage_t, N> slots;
+};
+
+// Owns the lanes of one mpsc_lanes. Shared with the thread-local lane
+// handles so that a producer exiting after the queue is gone can still
+// give its lane back.
+template<typename T, size_t N>
+class lane_registry {
+public:
+    using lane_t = spsc_lane<T, N>;
+
+    lane_registry() = default;
+    lane_registry(const lane_registry&) = delete;
+    lane_registry& operator=(const lane_registry&) = delete;
+
+    ~lane_registry() {
+        lane_t* lane = this->lanes.load(std::memory_order_acquire);
+        while (lane) {
+            while (lane->pop_front()) {}
+            delete std::exchange(lane, lane->next);
+        }
+    }
+
+    // Reuses the lane of an exited producer, leftovers in it stay in order
+    lane_t* acquire_lane() {
+        for (lane_t* lane = this->head(); lane; lane = lane->next) {
+            bool expected = false;
+            if (!lane->in_use.load(std::memory_order_relaxed) &&
+                lane->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return lane;
+            }
+        }
+        auto* lane = new lane_t();
+        lane->next = this->lanes.load(std::memory_order_relaxed);
+        while (!this->lanes.compare_exchange_weak(lane->next, lane, std::memory_order_release, std::memory_order_relaxed)) {}
+        return lane;
+    }
+
+    void release_lane(lane_t* lane) {
+        lane->in_use.store(false, std::memory_order_release);
+    }
+
+    lane_t* head() const {
+        return this->lanes.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<lane_t*> lanes{nullptr};
+};
+
+}
+
+// MPSC queue made of one SPSC lane per producer thread. A thread gets its
+// lane on its first push, so producers never touch a shared cache line;
+// the consumer round-robins over the lanes. Order is FIFO per producer.
+//
+// Lanes are bounded: try_emplace_back fails and emplace_back waits while
+// the calling thread's lane is full.
+template <typename T, size_t N = 1024>
+class mpsc_lanes {
+public:
+    mpsc_lanes() : registry(std::make_shared<registry_t>()) {}
+
+    ~mpsc_lanes() {
+        while (this->pop_front()) {}
+    }
+
+    mpsc_lanes(const mpsc_lanes&) = delete;
+    mpsc_lanes(mpsc_lanes&&) = delete;
+    mpsc_lanes& operator=(const mpsc_lanes&) = delete;
+    mpsc_lanes& operator=(mpsc_lanes&&) = delete;
+
+    template<typename... args_t>
+    bool try_emplace_back(args_t&&... args) {
+        return this->local_lane()->try_emplace_back(std::forward<args_t>(args)...);
+    }
+
+    template<typename... args_t>
+    void emplace_back(args_t&&... args) {
+        auto* lane = this->local_lane();
+        while (!lane->try_emplace_back(std::forward<args_t>(args)...)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void push_back(const T& item) { this->emplace_back(item); }
+
+    void push_back(T&& item) { this->emplace_back(std::move(item)); }
+
+    // Consumer only
+    std::optional<T> pop_front();
+
+    // Consumer only, moves up to `max` elements to `out`
+    template<typename out_t>
+    size_t pop_bulk(out_t out, size_t max);
+
+    size_t size() const {
+        size_t count = 0;
+        for (auto* lane = this->registry->head(); lane; lane = lane->next) {
+            count += lane->size();
+        }
+        return count;
+    }
+
+private:
+    using registry_t = detail::lane_registry<T, N>;
+    using lane_t = typename registry_t::lane_t;
+
+    struct tls_t {
+        tls_t() = default;
+        ~tls_t() {
+            for (auto& [registry, lane] : this->map) {
+                registry->release_lane(lane);
+            }
+        }
+        registry_t* last_registry{nullptr};
+        lane_t* last_lane{nullptr};
+        std::unordered_map<std::shared_ptr<registry_t>, lane_t*> map{};
+    };
+
+    lane_t* local_lane() {
+        static thread_local tls_t tls{};
+        // The map keeps the registry alive, so its address is never reused
+        // while the cached pointer can match
+        if (tls.last_registry == this->registry.get()) {
+            return tls.last_lane;
+        }
+        auto it = tls.map.find(this->registry);
+        if (it == tls.map.end()) {
+            // Drop lanes of queues that are gone, this thread holds the last reference
+            std::erase_if(tls.map, [](const auto& entry) {
+                return entry.first.use_count() == 1;
+            });
+            it = tls.map.emplace(this->registry, this->registry->acquire_lane()).first;
+        }
+        tls.last_registry = it->first.get();
+        tls.last_lane = it->second;
+        return it->second;
+    }
+
+    // Next lane in round-robin order, wrapping around to the newest one
+    lane_t* next_lane(lane_t* lane) const {
+        return lane && lane->next ? lane->next : this->registry->head();
+    }
+
+    std::shared_ptr<registry_t> registry;
+    lane_t* cursor{nullptr};    // consumer only
+};
+
+template <typename T, size_t N>
+std::optional<T> mpsc_lanes<T, N>::pop_front() {
+    lane_t* start = this->next_lane(this->cursor);
+    if (!start) {
+        return std::nullopt;
+    }
+    lane_t* lane = start;
+    do {
+        if (auto item = lane->pop_front(); item) {
+            this->cursor = lane;
+            return item;
+        }
+        lane = this->next_lane(lane);
+    } while (lane != start);
+    return std::nullopt;
+}
+
+template <typename T, size_t N>
+template <typename out_t>
+size_t mpsc_lanes<T, N>::pop_bulk(out_t out, size_t max) {
+    size_t count = 0;
+    lane_t* start = this->next_lane(this->cursor);
+    if (!start || max == 0) {
+        return 0;
+    }
+    // Up to max / lanes per lane and round, so one busy producer cannot
+    // take the whole batch while others wait
+    size_t lanes = 0;
+    for (auto* lane = this->registry->head(); lane; lane = lane->next) {
+        ++lanes;
+    }
+    size_t share = std::max<size_t>(max / lanes, 1);
+    bool progress = true;
+    while (count < max && progress) {
+        progress = false;
+        lane_t* lane = start;
+        do {
+            for (size_t taken = 0; taken < share && count < max; ++taken) {
+                auto item = lane->pop_front();
+                if (!item) {
+                    break;
+                }
+                *out = std::move(*item);
+                ++out;
+                ++count;
+                progress = true;
+                this->cursor = lane;
+            }
+            lane = this->next_lane(lane);
+        } while (lane != start && count < max);
+    }
+    return count;
+}
+
+}
@@ -7,6 +7,8 @@
 #include <ranges>
 #include <algorithm>
 #include <utility>
+#include "concurrent/chunk_cache.h"
+#include "concurrent/ebr.h"
 #include "concurrent/hp.h"
 namespace concurrent {
 
@@ -38,6 +40,21 @@ struct mpsc_chunk{
     template<typename... args_t>
     bool emplace_back(args_t&&... args);
 
+    // Reserves up to `count` slots with one CAS and constructs them from
+    // `first`, returns how many were taken (0 once the chunk is full).
+    template<typename iter_t>
+    size_t emplace_bulk(iter_t& first, size_t count);
+
+    // Moves up to `max` elements to `out`, returns how many.
+    template<typename out_t>
+    size_t pop_bulk(out_t& out, size_t max);
+
+    // Every slot has been handed to a consumer
+    bool drained() const;
+
+    // back to the freshly constructed state, for a drained chunk
+    void reset();
+
     ~mpsc_chunk();
 };
 
@@ -77,6 +94,59 @@ bool mpsc_chunk<T, MAX_NODES>::emplace_back(args_t&&... args) {
         }
     }
 }
+template<typename T, size_t MAX_NODES>
+template<typename iter_t>
+size_t mpsc_chunk<T, MAX_NODES>::emplace_bulk(iter_t& first, size_t count) {
+
+    while (true) {
+        size_t write_idx = write_index.load(std::memory_order_acquire);
+        if (write_idx == MAX_NODES) {
+            return 0; // chunk is full
+        }
+        size_t reserved = std::min(count, MAX_NODES - write_idx);
+        if (this->write_index.compare_exchange_strong(write_idx, write_idx + reserved, std::memory_order_release, std::memory_order_relaxed)){
+            for (size_t i = write_idx; i < write_idx + reserved; ++i, ++first) {
+                new (&data[i].storage) T(*first);
+                data[i].status.store(READY, std::memory_order_release);
+            }
+            return reserved;
+        }
+    }
+}
+
+template<typename T, size_t MAX_NODES>
+template<typename out_t>
+size_t mpsc_chunk<T, MAX_NODES>::pop_bulk(out_t& out, size_t max){
+    size_t write_idx = write_index.load(std::memory_order_acquire);
+    size_t count = std::min(max, write_idx > this->read_index ? write_idx - this->read_index : 0);
+    for (size_t i = this->read_index; i < this->read_index + count; ++i) {
+        while (data[i].status.load(std::memory_order_acquire) != READY) {
+            // wait until the data is ready
+        }
+        *out = std::move(data[i].get());
+        ++out;
+        data[i].get().~T();
+        data[i].status.store(USED, std::memory_order_release);
+    }
+    this->read_index += count;
+    return count;
+}
+
+template<typename T, size_t MAX_NODES>
+bool mpsc_chunk<T, MAX_NODES>::drained() const {
+    return this->read_index == MAX_NODES;
+}
+
+template<typename T, size_t MAX_NODES>
+void mpsc_chunk<T, MAX_NODES>::reset(){
+    for (auto& node : data) {
+        node.status.store(EMPTY, std::memory_order_relaxed);
+    }
+    this->read_index = 0;
+    this->write_index.store(0, std::memory_order_relaxed);
+    this->next.store(nullptr, std::memory_order_relaxed);
+}
+
 template<typename T, size_t MAX_NODES>
 mpsc_chunk<T, MAX_NODES>::~mpsc_chunk(){
     for (size_t i = read_index; i < write_index; ++i) {
@@ -85,10 +155,15 @@ mpsc_chunk<T, MAX_NODES>::~mpsc_chunk(){
 };
 
 
-template <typename T, size_t N = 64>
+// reclaimer_t decides how retired chunks are freed: hazard_manager
+// (default) or epoch_manager, see concurrent/ebr.h.
+// Drained chunks are kept for reuse, up to CACHED_CHUNKS, which is 0 to
+// disable it or a power of 2.
+template <typename T, size_t N = 64, typename reclaimer_t = hazard_manager, size_t CACHED_CHUNKS = 16>
 class mpsc_queue {
 private:
     using chunk_t = mpsc_chunk<T, N>;
+    using cache_t = detail::chunk_cache<chunk_t, CACHED_CHUNKS>;
 
 public:
     mpsc_queue();
@@ -100,37 +175,54 @@ public:
 
     template<typename... args_t>
     void emplace_back(args_t&&... args);
+
+    // Constructs every element of `items` in order, one CAS per chunk
+    // touched instead of one per element.
+    template<std::ranges::sized_range range_t>
+    void emplace_back_bulk(range_t&& items);
     
     std::optional<T> pop_front();
+
+    // Moves up to `max` elements to the output iterator `out`,
+    // returns how many were popped.
+    template<typename out_t>
+    size_t pop_bulk(out_t out, size_t max);
     
 
 private:
+    // The tail chunk is full: link a new one or help the tail forward.
+    // Expects the tail hazard to be held and clears it.
+    void advance_tail(chunk_t* old_tail);
+
     alignas(64) chunk_t* head_chunk;
     alignas(64) std::atomic<chunk_t*> tail_chunk;
-    alignas(64) hazard_manager hp;
+    alignas(64) reclaimer_t reclaimer;
+    cache_t* cache;
 };
 
 
-template <typename T, size_t N>
-mpsc_queue<T, N>::mpsc_queue(){
-    chunk_t* dummy = new chunk_t();
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::mpsc_queue(){
+    cache = cache_t::create();
+    chunk_t* dummy = cache->acquire();
     head_chunk = dummy;
     tail_chunk.store(dummy, std::memory_order_relaxed);
 }
 
-template <typename T, size_t N>
-mpsc_queue<T, N>::~mpsc_queue() {
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::~mpsc_queue() {
     chunk_t* current = head_chunk;
     while (current) {
         chunk_t* next = current->next.load(std::memory_order_relaxed);
-        delete current;
+        cache_t::destroy(current);
         current = next;
     }
+    cache->release();
 }
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
 template<typename... args_t>
-void mpsc_queue<T, N>::emplace_back(args_t&&... args) {
+void mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::emplace_back(args_t&&... args) {
 
     constexpr size_t HAZ_TAIL = 0;
 
@@ -138,53 +230,80 @@ void mpsc_queue<T, N>::emplace_back(args_t&&... args) {
     
     while (true) {
         chunk_t* old_tail = this->tail_chunk.load(std::memory_order_acquire);
-        hp.protect<HAZ_TAIL>(old_tail);
+        this->reclaimer.template protect<HAZ_TAIL>(old_tail);
         if (old_tail != this->tail_chunk.load(std::memory_order_acquire)) {
             continue; // Tail was updated, retry
         }
         if (old_tail->emplace_back(std::forward<args_t>(args)...)) {
-            hp.clear<HAZ_TAIL>();
+            this->reclaimer.template clear<HAZ_TAIL>();
             return; // successfully added
         }
 
         // If we reach here, it means the current chunk is full
-        // We need to create a new chunk and link it
-        
-        chunk_t* new_chunk = new chunk_t();                
-        auto next = old_tail->next.load(std::memory_order_acquire);
+        this->advance_tail(old_tail);
+    }
+}
 
-        if (next == nullptr) {
-            if (old_tail->next.compare_exchange_strong(
-                next, new_chunk,
+
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+void mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::advance_tail(chunk_t* old_tail) {
+    constexpr size_t HAZ_TAIL = 0;
+
+    
+    auto next = old_tail->next.load(std::memory_order_acquire);
+
+    if (next == nullptr) {
+        chunk_t* new_chunk = this->cache->acquire();
+        if (old_tail->next.compare_exchange_strong(
+            next, new_chunk,
+            std::memory_order_release,
+            std::memory_order_relaxed
+        )) {
+            this->tail_chunk.compare_exchange_strong(
+                old_tail, new_chunk,
                 std::memory_order_release,
                 std::memory_order_relaxed
-            )) {
-                this->tail_chunk.compare_exchange_strong(
-                    old_tail, new_chunk,
-                    std::memory_order_relaxed,
-                    std::memory_order_relaxed
-                );
-                hp.clear<HAZ_TAIL>();                     
-                continue; // successfully linked new chunk
-            }
-
+            );
+            this->reclaimer.template clear<HAZ_TAIL>();                     
+            return; // successfully linked new chunk
         }
-        // Tail was not the last node, so we need to update it
-        this->tail_chunk.compare_exchange_strong(
-            old_tail, next,
-            std::memory_order_relaxed,
-            std::memory_order_relaxed
-        );
-        hp.clear<HAZ_TAIL>(); 
-                        
-        
-        delete new_chunk; // clean up the new chunk if it was not used
+        // never published, hand it straight back
+        this->cache->recycle(new_chunk);
     }
+    // Tail was not the last node, so we need to update it
+    this->tail_chunk.compare_exchange_strong(
+        old_tail, next,
+        std::memory_order_release,
+        std::memory_order_relaxed
+    );
+    this->reclaimer.template clear<HAZ_TAIL>(); 
 }
 
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+template<std::ranges::sized_range range_t>
+void mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::emplace_back_bulk(range_t&& items) {
+
+    constexpr size_t HAZ_TAIL = 0;
 
-template <typename T, size_t N>
-std::optional<T> mpsc_queue<T, N>::pop_front() {
+    auto first = std::ranges::begin(items);
+    size_t remaining = std::ranges::size(items);
+    while (remaining > 0) {
+        chunk_t* old_tail = this->tail_chunk.load(std::memory_order_acquire);
+        this->reclaimer.template protect<HAZ_TAIL>(old_tail);
+        if (old_tail != this->tail_chunk.load(std::memory_order_acquire)) {
+            continue; // Tail was updated, retry
+        }
+        remaining -= old_tail->emplace_bulk(first, remaining);
+        if (remaining == 0) {
+            this->reclaimer.template clear<HAZ_TAIL>();
+            return; // successfully added
+        }
+        this->advance_tail(old_tail);
+    }
+}
+
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+std::optional<T> mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::pop_front() {
     
     while (true) {
         chunk_t* dummy = this->head_chunk;
@@ -200,6 +319,9 @@ std::optional<T> mpsc_queue<T, N>::pop_front() {
         if (next == nullptr) {
             return std::nullopt;
         }
+        if (!dummy->drained()) {
+            continue; // filled up before `next` was linked
+        }
 
 
         // if tail is behind, try to update it
@@ -212,7 +334,8 @@ std::optional<T> mpsc_queue<T, N>::pop_front() {
         }                          
 
         head_chunk = next;
-        hp.retire(dummy); // retire the old head chunk
+        this->cache->retain();
+        this->reclaimer.retire(dummy, &cache_t::recycle_retired); // retire the old head chunk
         // successfully updated head        
     }
 
@@ -220,4 +343,38 @@ std::optional<T> mpsc_queue<T, N>::pop_front() {
 
 
 
-}
\ No newline at end of file
+template <typename T, size_t N, typename reclaimer_t, size_t CACHED_CHUNKS>
+template<typename out_t>
+size_t mpsc_queue<T, N, reclaimer_t, CACHED_CHUNKS>::pop_bulk(out_t out, size_t max) {
+    size_t count = 0;
+    while (count < max) {
+        chunk_t* dummy = this->head_chunk;
+        count += dummy->pop_bulk(out, max - count);
+        if (count == max) {
+            break;
+        }
+
+        chunk_t* next = dummy->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            break;
+        }
+        if (!dummy->drained()) {
+            continue; // filled up before `next` was linked
+        }
+
+        chunk_t* tail_now = tail_chunk.load(std::memory_order_acquire);
+        if (tail_now == dummy) {
+            tail_chunk.compare_exchange_strong(
+                tail_now, next,
+                std::memory_order_release,
+                std::memory_order_relaxed);
+        }
+
+        head_chunk = next;
+        this->cache->retain();
+        this->reclaimer.retire(dummy, &cache_t::recycle_retired);
+    }
+    return count;
+}
+
+}
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
 #include <optional>
+#include <ranges>
 
 namespace concurrent {
 
@@ -38,6 +40,15 @@ public:
     template<typename... args_t>
     bool emplace_back(args_t&&... args);
 
+    // Reserves as many slots as fit with one CAS and constructs them from
+    // the front of `items`, returns how many were pushed.
+    template<std::ranges::sized_range range_t>
+    size_t emplace_back_bulk(range_t&& items);
+
+    // Moves up to `max` elements to the output iterator `out`,
+    // returns how many were popped.
+    template<typename out_t>
+    size_t pop_bulk(out_t out, size_t max);
 
 private:
     node_t& get_node(size_t index) {
@@ -66,6 +77,50 @@ bool mpsc_ringbuffer<T, N>::emplace_back(args_t&&... args) {
     }
 }
 
+template<typename T, size_t N>
+template<std::ranges::sized_range range_t>
+size_t mpsc_ringbuffer<T, N>::emplace_back_bulk(range_t&& items) {
+    size_t count = std::ranges::size(items);
+    while (true) {
+        size_t write_idx = write_index.load(std::memory_order_acquire);
+        size_t read_idx = read_index.load(std::memory_order_acquire);
+        size_t reserved = std::min(count, N - (write_idx - read_idx));
+        if (reserved == 0) {
+            return 0; // buffer is full
+        }
+        if (this->write_index.compare_exchange_strong(write_idx, write_idx + reserved, std::memory_order_release, std::memory_order_relaxed)){
+            auto it = std::ranges::begin(items);
+            for (size_t i = write_idx; i < write_idx + reserved; ++i, ++it) {
+                new (&this->get_node(i).storage) T(*it);
+                this->get_node(i).status.store(READY, std::memory_order_release);
+            }
+            return reserved;
+        }
+    }
+}
+
+template<typename T, size_t N>
+template<typename out_t>
+size_t mpsc_ringbuffer<T, N>::pop_bulk(out_t out, size_t max){
+    size_t write_idx = write_index.load(std::memory_order_acquire);
+    size_t read_idx = read_index.load(std::memory_order_acquire);
+    size_t count = std::min(max, write_idx - read_idx);
+
+    for (size_t i = read_idx; i < read_idx + count; ++i) {
+        auto& node = this->get_node(i);
+        while (node.status.load(std::memory_order_acquire) != READY) {
+            // wait until the data is ready
+        }
+        *out = std::move(node.get());
+        ++out;
+        node.get().~T();
+        node.status.store(EMPTY, std::memory_order_release);
+    }
+    // one release for the whole batch
+    this->read_index.fetch_add(count, std::memory_order_release);
+    return count;
+}
+
 
 template<typename T, size_t N>
 T mpsc_ringbuffer<T, N>::unsafe_pop_front(){
@@ -0,0 +1,357 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <print>
+#include <thread>
+#include <utility>
+
+namespace concurrent {
+
+struct object_pool_stats {
+    size_t allocations;     // successful allocate() calls
+    size_t deallocations;
+    size_t in_use;          // allocations - deallocations
+    size_t owned;           // objects backed by heap memory, in use or cached
+    size_t heap_allocs;     // objects that had to come from the heap
+    size_t heap_frees;      // cached objects given back to the heap by trimming
+    size_t depot_hits;      // magazine refills served by the depot
+    size_t exhausted;       // allocate() calls refused by max_objects
+};
+
+namespace detail {
+
+inline size_t pool_thread_index() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+}
+
+// Magazine allocator after Bonwick & Adams: every shard keeps two
+// magazines (small stacks of free objects) so that most allocate/deallocate
+// pairs never leave the shard. Full and empty magazines are exchanged with a
+// global depot, and only a depot miss falls through to the heap.
+// Threads are spread over the shards by a per-thread index, with at least as
+// many shards as hardware threads a shard lock is practically uncontended.
+//
+// max_objects bounds the number of objects backed by heap memory (0 means
+// unbounded), allocate() returns nullptr once it is reached.
+// trim_idle() gives back what the depot has not needed since the previous
+// call, trim() gives back everything that is cached.
+template <typename T, size_t MAGAZINE = 32>
+class object_pool {
+public:
+    explicit object_pool(size_t max_objects = 0, size_t shard_count = std::thread::hardware_concurrency()) :
+        max_objects(max_objects),
+        shard_mask(std::bit_ceil(std::max<size_t>(shard_count, 1)) - 1),
+        shards(new shard_t[this->shard_mask + 1])
+    {}
+
+    ~object_pool();
+
+    object_pool(const object_pool&) = delete;
+    object_pool(object_pool&&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+    object_pool& operator=(object_pool&&) = delete;
+
+    template<typename... args_t>
+    T* allocate(args_t&&... args);
+
+    void deallocate(T* obj);
+
+    void trim_idle();
+
+    void trim();
+
+    object_pool_stats stats() const;
+
+private:
+    struct alignas(alignof(T)) storage_t {
+        std::byte data[sizeof(T)];
+    };
+
+    struct magazine_t {
+        size_t count{0};
+        std::array<storage_t*, MAGAZINE> slots{};
+        magazine_t* next{nullptr};
+
+        bool empty() const { return this->count == 0; }
+        bool full() const { return this->count == MAGAZINE; }
+    };
+
+    struct spinlock_t {
+        void lock() {
+            while (this->flag.test_and_set(std::memory_order_acquire)) {
+                while (this->flag.test(std::memory_order_relaxed)) {}
+            }
+        }
+        void unlock() {
+            this->flag.clear(std::memory_order_release);
+        }
+        std::atomic_flag flag{};
+    };
+
+    struct alignas(64) shard_t {
+        spinlock_t lock{};
+        magazine_t* loaded{nullptr};
+        magazine_t* previous{nullptr};
+        // written under the lock, read by stats()
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> deallocations{0};
+
+        void count(std::atomic<size_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    // Magazines in a singly linked list, min_count tracks the working set
+    // between two trim_idle() calls
+    struct magazine_list_t {
+        magazine_t* head{nullptr};
+        size_t count{0};
+        size_t min_count{0};
+
+        void push(magazine_t* mag) {
+            mag->next = this->head;
+            this->head = mag;
+            ++this->count;
+        }
+        magazine_t* pop() {
+            magazine_t* mag = this->head;
+            if (mag) {
+                this->head = mag->next;
+                this->min_count = std::min(this->min_count, --this->count);
+            }
+            return mag;
+        }
+    };
+
+    shard_t& current_shard() {
+        return this->shards[detail::pool_thread_index() & this->shard_mask];
+    }
+
+    storage_t* pop_slow(shard_t& shard);
+
+    void push_slow(shard_t& shard, storage_t* slot);
+
+    storage_t* heap_allocate();
+
+    void release(magazine_t* mag);
+
+    const size_t max_objects;
+    const size_t shard_mask;
+    std::unique_ptr<shard_t[]> shards;
+
+    alignas(64) mutable std::mutex depot_mutex{};
+    magazine_list_t depot_full{};
+    magazine_list_t depot_empty{};
+    size_t depot_hits{0};
+
+    alignas(64) std::atomic<size_t> owned{0};
+    std::atomic<size_t> heap_allocs{0};
+    std::atomic<size_t> heap_frees{0};
+    std::atomic<size_t> exhausted{0};
+};
+
+template <typename T, size_t MAGAZINE>
+template <typename... args_t>
+T* object_pool<T, MAGAZINE>::allocate(args_t&&... args) {
+    auto& shard = this->current_shard();
+    storage_t* slot;
+    {
+        std::lock_guard lock{shard.lock};
+        if (shard.loaded && !shard.loaded->empty()) {
+            slot = shard.loaded->slots[--shard.loaded->count];
+        } else {
+            slot = this->pop_slow(shard);
+        }
+        if (slot) {
+            shard.count(shard.allocations);
+        }
+    }
+    if (!slot) {
+        slot = this->heap_allocate();
+        if (!slot) {
+            return nullptr;
+        }
+        std::lock_guard lock{shard.lock};
+        shard.count(shard.allocations);
+    }
+    return new (slot->data) T(std::forward<args_t>(args)...);
+}
+
+template <typename T, size_t MAGAZINE>
+void object_pool<T, MAGAZINE>::deallocate(T* obj) {
+    obj->~T();
+    auto* slot = reinterpret_cast<storage_t*>(obj);
+    auto& shard = this->current_shard();
+    std::lock_guard lock{shard.lock};
+    if (shard.loaded && !shard.loaded->full()) {
+        shard.loaded->slots[shard.loaded->count++] = slot;
+    } else {
+        this->push_slow(shard, slot);
+    }
+    shard.count(shard.deallocations);
+}
+
+// Called with the shard locked and the loaded magazine empty
+template <typename T, size_t MAGAZINE>
+auto object_pool<T, MAGAZINE>::pop_slow(shard_t& shard) -> storage_t* {
+    if (shard.previous && !shard.previous->empty()) {
+        std::swap(shard.loaded, shard.previous);
+        return shard.loaded->slots[--shard.loaded->count];
+    }
+    std::lock_guard lock{this->depot_mutex};
+    magazine_t* full = this->depot_full.pop();
+    if (!full) {
+        return nullptr;
+    }
+    ++this->depot_hits;
+    if (shard.previous) {
+        this->depot_empty.push(shard.previous);
+    }
+    shard.previous = shard.loaded;
+    shard.loaded = full;
+    return shard.loaded->slots[--shard.loaded->count];
+}
+
+// Called with the shard locked and the loaded magazine full (or missing)
+template <typename T, size_t MAGAZINE>
+void object_pool<T, MAGAZINE>::push_slow(shard_t& shard, storage_t* slot) {
+    if (shard.previous && !shard.previous->full()) {
+        std::swap(shard.loaded, shard.previous);
+        shard.loaded->slots[shard.loaded->count++] = slot;
+        return;
+    }
+    magazine_t* empty;
+    {
+        std::lock_guard lock{this->depot_mutex};
+        empty = this->depot_empty.pop();
+        if (shard.previous) {
+            this->depot_full.push(shard.previous);
+        }
+    }
+    if (!empty) {
+        empty = new magazine_t();
+    }
+    shard.previous = shard.loaded;
+    shard.loaded = empty;
+    shard.loaded->slots[shard.loaded->count++] = slot;
+}
+
+template <typename T, size_t MAGAZINE>
+auto object_pool<T, MAGAZINE>::heap_allocate() -> storage_t* {
+    size_t n = this->owned.fetch_add(1, std::memory_order_relaxed);
+    if (this->max_objects && n >= this->max_objects) {
+        this->owned.fetch_sub(1, std::memory_order_relaxed);
+        this->exhausted.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    this->heap_allocs.fetch_add(1, std::memory_order_relaxed);
+    return new storage_t;
+}
+
+// Frees the magazine and every object cached in it
+template <typename T, size_t MAGAZINE>
+void object_pool<T, MAGAZINE>::release(magazine_t* mag) {
+    for (size_t i = 0; i < mag->count; ++i) {
+        delete mag->slots[i];
+    }
+    this->owned.fetch_sub(mag->count, std::memory_order_relaxed);
+    this->heap_frees.fetch_add(mag->count, std::memory_order_relaxed);
+    delete mag;
+}
+
+template <typename T, size_t MAGAZINE>
+void object_pool<T, MAGAZINE>::trim_idle() {
+    magazine_t* unused = nullptr;
+    {
+        std::lock_guard lock{this->depot_mutex};
+        for (auto* list : {&this->depot_full, &this->depot_empty}) {
+            for (size_t n = list->min_count; n > 0; --n) {
+                magazine_t* mag = list->pop();
+                mag->next = unused;
+                unused = mag;
+            }
+            list->min_count = list->count;
+        }
+    }
+    while (unused) {
+        this->release(std::exchange(unused, unused->next));
+    }
+}
+
+template <typename T, size_t MAGAZINE>
+void object_pool<T, MAGAZINE>::trim() {
+    for (size_t i = 0; i <= this->shard_mask; ++i) {
+        auto& shard = this->shards[i];
+        magazine_t* loaded;
+        magazine_t* previous;
+        {
+            std::lock_guard lock{shard.lock};
+            loaded = std::exchange(shard.loaded, nullptr);
+            previous = std::exchange(shard.previous, nullptr);
+        }
+        for (auto* mag : {loaded, previous}) {
+            if (mag) {
+                this->release(mag);
+            }
+        }
+    }
+    magazine_t* cached = nullptr;
+    {
+        std::lock_guard lock{this->depot_mutex};
+        for (auto* list : {&this->depot_full, &this->depot_empty}) {
+            while (magazine_t* mag = list->pop()) {
+                mag->next = cached;
+                cached = mag;
+            }
+            list->min_count = 0;
+        }
+    }
+    while (cached) {
+        this->release(std::exchange(cached, cached->next));
+    }
+}
+
+template <typename T, size_t MAGAZINE>
+object_pool_stats object_pool<T, MAGAZINE>::stats() const {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    for (size_t i = 0; i <= this->shard_mask; ++i) {
+        allocations += this->shards[i].allocations.load(std::memory_order_relaxed);
+        deallocations += this->shards[i].deallocations.load(std::memory_order_relaxed);
+    }
+    size_t depot_hits;
+    {
+        std::lock_guard lock{this->depot_mutex};
+        depot_hits = this->depot_hits;
+    }
+    return {
+        allocations,
+        deallocations,
+        allocations - std::min(allocations, deallocations),
+        this->owned.load(std::memory_order_relaxed),
+        this->heap_allocs.load(std::memory_order_relaxed),
+        this->heap_frees.load(std::memory_order_relaxed),
+        depot_hits,
+        this->exhausted.load(std::memory_order_relaxed)
+    };
+}
+
+template <typename T, size_t MAGAZINE>
+object_pool<T, MAGAZINE>::~object_pool() {
+    this->trim();
+    if (size_t leaked = this->owned.load(std::memory_order_acquire); leaked > 0) {
+        std::println("Memory leak detected in object_pool, {} objects were not deallocated", leaked);
+    }
+}
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace concurrent {
+
+struct lru_stats {
+    size_t hits;
+    size_t misses;          // includes lookups that found an expired entry
+    size_t expired;         // entries dropped because their ttl ran out
+    size_t evictions;       // entries dropped to stay under max_bytes
+    size_t insertions;
+    size_t entries;
+    size_t bytes;
+};
+
+namespace detail {
+
+// Bytes charged for an entry when no size function is given: the object
+// sizes plus the heap payload of anything that has size() over chars
+struct lru_default_size {
+    template<typename K, typename V>
+    size_t operator()(const K& key, const V& value) const {
+        return sizeof(K) + sizeof(V) + payload(key) + payload(value);
+    }
+
+    template<typename T>
+    static size_t payload(const T& v) {
+        if constexpr (requires { { v.size() } -> std::convertible_to<size_t>; typename T::value_type; }) {
+            return v.size() * sizeof(typename T::value_type);
+        } else {
+            return 0;
+        }
+    }
+};
+
+}
+
+// Sharded LRU cache with per-entry TTL and a byte budget.
+// Every shard is a mutex-protected hash map plus recency list, the lock is
+// only held for the map/list update so that coroutines can use the cache
+// from io workers. Values are shared as std::shared_ptr<const V>: a reader
+// keeps its value alive after eviction without copying it, and evicted
+// values are destroyed after the shard lock is released.
+//
+// cache.put(path, response, 5s);
+// if (auto hit = cache.get(path)) { ... *hit ... }
+template<
+    typename K,
+    typename V,
+    typename hash_t = std::hash<K>,
+    typename size_fn_t = detail::lru_default_size
+>
+class sharded_lru {
+public:
+    using clock = std::chrono::steady_clock;
+    using value_ptr = std::shared_ptr<const V>;
+
+    struct config {
+        size_t          max_bytes{64 * 1024 * 1024};
+        size_t          shards{16};
+        clock::duration default_ttl{clock::duration::zero()};   // zero means entries never expire
+    };
+
+    sharded_lru() : sharded_lru(config{}) {}
+
+    explicit sharded_lru(const config& cfg) :
+        shard_count(std::bit_ceil(std::max<size_t>(cfg.shards, 1))),
+        shard_bytes(std::max<size_t>(cfg.max_bytes / this->shard_count, 1)),
+        default_ttl(cfg.default_ttl),
+        shards(new shard_t[this->shard_count])
+    {}
+
+    sharded_lru(const sharded_lru&) = delete;
+    sharded_lru(sharded_lru&&) = delete;
+    sharded_lru& operator=(const sharded_lru&) = delete;
+    sharded_lru& operator=(sharded_lru&&) = delete;
+
+    // nullptr on a miss or an expired entry
+    value_ptr get(const K& key);
+
+    void put(K key, V value) {
+        this->put(std::move(key), std::make_shared<const V>(std::move(value)), this->default_ttl);
+    }
+
+    void put(K key, V value, clock::duration ttl) {
+        this->put(std::move(key), std::make_shared<const V>(std::move(value)), ttl);
+    }
+
+    void put(K key, value_ptr value, clock::duration ttl);
+
+    bool erase(const K& key);
+
+    // Drops expired entries, lookups only notice those they run into
+    size_t purge_expired();
+
+    void clear();
+
+    lru_stats stats() const;
+
+private:
+    struct entry_t {
+        K                 key;
+        value_ptr         value;
+        size_t            bytes;
+        clock::time_point expires;  // time_point::max() without ttl
+    };
+    using list_t = std::list<entry_t>;
+
+    struct alignas(64) shard_t {
+        mutable std::mutex mutex{};
+        list_t lru{};   // most recently used at the front
+        std::unordered_map<K, typename list_t::iterator, hash_t> index{};
+        size_t bytes{0};
+
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> expired{0};
+        std::atomic<size_t> evictions{0};
+        std::atomic<size_t> insertions{0};
+
+        // Moves the entry to `out`, destroyed by the caller after unlocking
+        void unlink(typename list_t::iterator it, list_t& out) {
+            this->bytes -= it->bytes;
+            this->index.erase(it->key);
+            out.splice(out.end(), this->lru, it);
+        }
+    };
+
+    shard_t& shard_of(const K& key) {
+        // fibonacci hashing, the map itself uses the low bits of the same hash
+        uint64_t h = static_cast<uint64_t>(hash_t{}(key)) * 0x9E3779B97F4A7C15ull;
+        return this->shards[(h >> 32) & (this->shard_count - 1)];
+    }
+
+    const size_t shard_count;
+    const size_t shard_bytes;
+    const clock::duration default_ttl;
+    std::unique_ptr<shard_t[]> shards;
+};
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+auto sharded_lru<K, V, hash_t, size_fn_t>::get(const K& key) -> value_ptr {
+    auto& shard = this->shard_of(key);
+    list_t dropped;
+    std::lock_guard lock{shard.mutex};
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    auto it = found->second;
+    if (it->expires <= clock::now()) {
+        shard.unlink(it, dropped);
+        shard.expired.fetch_add(1, std::memory_order_relaxed);
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    return it->value;
+}
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+void sharded_lru<K, V, hash_t, size_fn_t>::put(K key, value_ptr value, clock::duration ttl) {
+    size_t bytes = size_fn_t{}(key, *value);
+    auto expires = ttl > clock::duration::zero() ? clock::now() + ttl : clock::time_point::max();
+    auto& shard = this->shard_of(key);
+    list_t dropped;
+    {
+        std::lock_guard lock{shard.mutex};
+        if (auto found = shard.index.find(key); found != shard.index.end()) {
+            shard.unlink(found->second, dropped);
+        }
+        // An entry larger than the whole shard is not cached at all
+        if (bytes > this->shard_bytes) {
+            return;
+        }
+        while (shard.bytes + bytes > this->shard_bytes) {
+            shard.unlink(std::prev(shard.lru.end()), dropped);
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.lru.emplace_front(std::move(key), std::move(value), bytes, expires);
+        shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+        shard.bytes += bytes;
+        shard.insertions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+bool sharded_lru<K, V, hash_t, size_fn_t>::erase(const K& key) {
+    auto& shard = this->shard_of(key);
+    list_t dropped;
+    std::lock_guard lock{shard.mutex};
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        return false;
+    }
+    shard.unlink(found->second, dropped);
+    return true;
+}
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+size_t sharded_lru<K, V, hash_t, size_fn_t>::purge_expired() {
+    size_t count = 0;
+    auto now = clock::now();
+    for (size_t i = 0; i < this->shard_count; ++i) {
+        auto& shard = this->shards[i];
+        list_t dropped;
+        std::lock_guard lock{shard.mutex};
+        for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+            auto next = std::next(it);
+            if (it->expires <= now) {
+                shard.unlink(it, dropped);
+                ++count;
+            }
+            it = next;
+        }
+        shard.expired.fetch_add(dropped.size(), std::memory_order_relaxed);
+    }
+    return count;
+}
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+void sharded_lru<K, V, hash_t, size_fn_t>::clear() {
+    for (size_t i = 0; i < this->shard_count; ++i) {
+        auto& shard = this->shards[i];
+        list_t dropped;
+        std::lock_guard lock{shard.mutex};
+        shard.index.clear();
+        dropped.splice(dropped.end(), shard.lru);
+        shard.bytes = 0;
+    }
+}
+
+template<typename K, typename V, typename hash_t, typename size_fn_t>
+lru_stats sharded_lru<K, V, hash_t, size_fn_t>::stats() const {
+    lru_stats s{};
+    for (size_t i = 0; i < this->shard_count; ++i) {
+        auto& shard = this->shards[i];
+        s.hits += shard.hits.load(std::memory_order_relaxed);
+        s.misses += shard.misses.load(std::memory_order_relaxed);
+        s.expired += shard.expired.load(std::memory_order_relaxed);
+        s.evictions += shard.evictions.load(std::memory_order_relaxed);
+        s.insertions += shard.insertions.load(std::memory_order_relaxed);
+        std::lock_guard lock{shard.mutex};
+        s.entries += shard.index.size();
+        s.bytes += shard.bytes;
+    }
+    return s;
+}
+
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+namespace concurrent {
+
+namespace detail {
+
+inline void futex_wake(std::atomic<uint32_t>& word, int count) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+// Sleeps while `word` holds `expected`. Returns false once `deadline`
+// (steady_clock, i.e. CLOCK_MONOTONIC) has passed.
+inline bool futex_wait(std::atomic<uint32_t>& word, uint32_t expected,
+                       std::chrono::steady_clock::time_point deadline) {
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+        return true;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec ts{ .tv_sec = ns / 1'000'000'000, .tv_nsec = ns % 1'000'000'000 };
+    long ret = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_BITSET_PRIVATE,
+                       expected, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+    return !(ret < 0 && errno == ETIMEDOUT);
+}
+
+}
+
+
+// Wraps any of the concurrent queues with blocking pops.
+// Consumers that find the queue empty announce themselves in `sleepers`
+// before parking on a futex, so a push costs one extra load and only
+// issues the wake syscall when somebody is actually parked.
+// wake_all() wakes every parked consumer without pushing anything, e.g.
+// after changing whatever the `stop` predicate of a waiting pop observes.
+template<typename queue_t>
+class waitable_queue {
+public:
+    using value_type = typename decltype(std::declval<queue_t&>().pop_front())::value_type;
+    using clock = std::chrono::steady_clock;
+
+    waitable_queue() = default;
+
+    waitable_queue(const waitable_queue&) = delete;
+    waitable_queue(waitable_queue&&) = delete;
+    waitable_queue& operator=(const waitable_queue&) = delete;
+    waitable_queue& operator=(waitable_queue&&) = delete;
+
+    // Same return type as the wrapped queue: void, or bool for the
+    // bounded queues that may refuse the element
+    template<typename... args_t>
+    auto emplace_back(args_t&&... args) {
+        if constexpr (std::is_void_v<decltype(this->queue.emplace_back(std::forward<args_t>(args)...))>) {
+            this->queue.emplace_back(std::forward<args_t>(args)...);
+            this->wake(1);
+        } else {
+            auto pushed = this->queue.emplace_back(std::forward<args_t>(args)...);
+            if (pushed) {
+                this->wake(1);
+            }
+            return pushed;
+        }
+    }
+
+    // For the bounded queues whose emplace_back blocks while they are full
+    template<typename... args_t>
+        requires requires (queue_t& q, args_t&&... args) { q.try_emplace_back(std::forward<args_t>(args)...); }
+    bool try_emplace_back(args_t&&... args) {
+        bool pushed = this->queue.try_emplace_back(std::forward<args_t>(args)...);
+        if (pushed) {
+            this->wake(1);
+        }
+        return pushed;
+    }
+
+    void push_back(const value_type& item) { this->emplace_back(item); }
+
+    void push_back(value_type&& item) { this->emplace_back(std::move(item)); }
+
+    template<typename range_t>
+        requires requires (queue_t& q, range_t&& r) { q.emplace_back_bulk(std::forward<range_t>(r)); }
+    auto emplace_back_bulk(range_t&& items) {
+        int count = static_cast<int>(std::min<size_t>(std::ranges::size(items), INT_MAX));
+        if constexpr (std::is_void_v<decltype(this->queue.emplace_back_bulk(std::forward<range_t>(items)))>) {
+            this->queue.emplace_back_bulk(std::forward<range_t>(items));
+            this->wake(count);
+        } else {
+            auto pushed = this->queue.emplace_back_bulk(std::forward<range_t>(items));
+            if (pushed) {
+                this->wake(static_cast<int>(pushed));
+            }
+            return pushed;
+        }
+    }
+
+    std::optional<value_type> pop_front() {
+        return this->queue.pop_front();
+    }
+
+    template<typename out_t>
+        requires requires (queue_t& q, out_t out) { q.pop_bulk(out, size_t{}); }
+    size_t pop_bulk(out_t out, size_t max) {
+        return this->queue.pop_bulk(out, max);
+    }
+
+    // Blocks until an element arrives, or returns nullopt once `stop()`
+    // holds while the queue is empty.
+    template<std::predicate stop_t>
+    std::optional<value_type> pop_front_wait(stop_t&& stop) {
+        return this->wait_until([this] { return this->queue.pop_front(); }, stop, clock::time_point::max());
+    }
+
+    template<typename rep_t, typename period_t>
+    std::optional<value_type> pop_front_wait_for(std::chrono::duration<rep_t, period_t> timeout) {
+        return this->wait_until([this] { return this->queue.pop_front(); }, [] { return false; }, clock::now() + timeout);
+    }
+
+    template<typename out_t, std::predicate stop_t>
+    size_t pop_bulk_wait(out_t out, size_t max, stop_t&& stop) {
+        return this->wait_until([this, out, max] { return this->queue.pop_bulk(out, max); }, stop, clock::time_point::max());
+    }
+
+    template<typename out_t, typename rep_t, typename period_t>
+    size_t pop_bulk_wait_for(out_t out, size_t max, std::chrono::duration<rep_t, period_t> timeout) {
+        return this->wait_until([this, out, max] { return this->queue.pop_bulk(out, max); }, [] { return false; }, clock::now() + timeout);
+    }
+
+    void wake_all() {
+        this->epoch.fetch_add(1, std::memory_order_seq_cst);
+        detail::futex_wake(this->epoch, INT_MAX);
+    }
+
+    size_t size() const
+        requires requires (const queue_t& q) { q.size(); }
+    {
+        return this->queue.size();
+    }
+
+    size_t sleeping() const {
+        return this->sleepers.load(std::memory_order_relaxed);
+    }
+
+    queue_t& unsafe_underlying() { return this->queue; }
+
+private:
+    static constexpr size_t spin_rounds = 64;
+
+    void wake(int count) {
+        // pairs with the seq_cst increment of `sleepers` in wait_until:
+        // either the consumer sees our element, or we see the consumer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->sleepers.load(std::memory_order_relaxed) > 0) {
+            this->epoch.fetch_add(1, std::memory_order_release);
+            detail::futex_wake(this->epoch, count);
+        }
+    }
+
+    template<typename pop_t, typename stop_t>
+    auto wait_until(pop_t&& try_pop, stop_t&& stop, clock::time_point deadline) -> decltype(try_pop()) {
+        for (size_t i = 0; i < spin_rounds; ++i) {
+            if (auto result = try_pop(); result) {
+                return result;
+            }
+        }
+        while (true) {
+            uint32_t seen = this->epoch.load(std::memory_order_acquire);
+            this->sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (auto result = try_pop(); result) {
+                this->sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return result;
+            }
+            if (stop()) {
+                this->sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return {};
+            }
+            bool woken = detail::futex_wait(this->epoch, seen, deadline);
+            this->sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (!woken) {
+                return try_pop();
+            }
+        }
+    }
+
+    queue_t queue{};
+    alignas(64) std::atomic<uint32_t> epoch{0};
+    alignas(64) std::atomic<uint32_t> sleepers{0};
+};
+
+}
@@ -1,9 +1,11 @@
 #pragma once
 #include <coroutine>
-#include <thread>
 #include <utility>
+#include "coro/completion.h"
 
 namespace coro{
+// Starts lazily, either when awaited by another coroutine,
+// or from a plain thread through sync_wait().
 template<typename return_t>
 class awaitable_task{
 public:
@@ -16,15 +18,8 @@ public:
             return std::suspend_always{};
         }
 
-        struct final_awaiter {
-            bool await_ready(){ return false; }
-            void await_resume(){}
-            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h){
-                return h.promise().previous;
-            }
-        };
         auto final_suspend() noexcept {
-            return final_awaiter{};
+            return detail::completion_awaiter{&this->completion};
         }
         void unhandled_exception(){}
 
@@ -35,7 +30,7 @@ public:
         void return_value(return_t&& v){
             result = std::move(v);
         }
-        std::coroutine_handle<> previous{std::noop_coroutine()};
+        detail::completion_state completion{};
         return_t result;
     };
 
@@ -44,13 +39,19 @@ public:
         return_t await_resume() { return std::move(coro.promise().result); }
         auto await_suspend(std::coroutine_handle<> h)
         {
-            coro.promise().previous = h;
+            coro.promise().completion.set_continuation(h);
             return coro;
         }
         std::coroutine_handle<promise_type> coro;
     };
-    awaiter operator co_await() { return this->handle; }
-    
+    awaiter operator co_await() { return awaiter{this->handle}; }
+
+    return_t sync_wait() {
+        this->handle.resume();
+        this->handle.promise().completion.wait();
+        return std::move(this->handle.promise().result);
+    }
+
     awaitable_task(promise_type* p): handle{handle_type::from_promise(*p)}{}
     ~awaitable_task(){
         this->handle.destroy();
@@ -60,4 +61,4 @@ private:
     handle_type handle;
 };
 
-}
\ No newline at end of file
+}
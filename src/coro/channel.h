@@ -0,0 +1,211 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "coro/sync.h"
+#include "coro/thread.h"
+
+namespace coro {
+
+// Bounded MPMC channel. Senders suspend while the buffer is full, receivers
+// suspend while it is empty. A capacity of 0 makes every send a rendezvous.
+//
+//  co_await ch.send(v)  -> bool, false if the channel is closed
+//  co_await ch.recv()   -> std::optional<T>, nullopt once closed and drained
+template<typename T>
+class channel {
+public:
+    struct send_awaiter : detail::waiter {
+        bool await_ready() { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            detail::waiter* to_resume = nullptr;
+            {
+                std::lock_guard lock{this->ch.guard};
+                if (this->ch.closed) {
+                    return false;
+                }
+                if (auto* r = this->ch.receivers.pop_front(); r) {
+                    static_cast<recv_awaiter*>(r)->value.emplace(std::move(this->value));
+                    to_resume = r;
+                } else if (this->ch.size < this->ch.slots.size()) {
+                    this->ch.push(std::move(this->value));
+                } else {
+                    this->ch.senders.push_back(this);
+                    return true;
+                }
+                this->ok = true;
+            }
+            if (to_resume) {
+                coro::thread::dispatch(to_resume->handle);
+            }
+            return false;
+        }
+
+        bool await_resume() { return this->ok; }
+
+        send_awaiter(channel& ch, T&& value) : ch(ch), value(std::move(value)) {}
+        channel& ch;
+        T        value;
+        bool     ok{false};
+    };
+
+    struct recv_awaiter : detail::waiter {
+        bool await_ready() { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            detail::waiter* to_resume = nullptr;
+            {
+                std::lock_guard lock{this->ch.guard};
+                if (this->ch.size > 0) {
+                    this->value.emplace(this->ch.pop());
+                    // a slot was freed, let one blocked sender in
+                    if (auto* s = this->ch.senders.pop_front(); s) {
+                        auto* sender = static_cast<send_awaiter*>(s);
+                        this->ch.push(std::move(sender->value));
+                        sender->ok = true;
+                        to_resume = s;
+                    }
+                } else if (auto* s = this->ch.senders.pop_front(); s) {
+                    // rendezvous with a sender on an unbuffered channel
+                    auto* sender = static_cast<send_awaiter*>(s);
+                    this->value.emplace(std::move(sender->value));
+                    sender->ok = true;
+                    to_resume = s;
+                } else if (!this->ch.closed) {
+                    this->ch.receivers.push_back(this);
+                    return true;
+                }
+            }
+            if (to_resume) {
+                coro::thread::dispatch(to_resume->handle);
+            }
+            return false;
+        }
+
+        std::optional<T> await_resume() { return std::move(this->value); }
+
+        explicit recv_awaiter(channel& ch) : ch(ch) {}
+        channel&         ch;
+        std::optional<T> value{};
+    };
+
+    explicit channel(size_t capacity) : slots(capacity) {}
+    channel(const channel&) = delete;
+    channel(channel&&) = delete;
+    channel& operator=(const channel&) = delete;
+    channel& operator=(channel&&) = delete;
+    ~channel() = default;
+
+    send_awaiter send(T value) { return send_awaiter{*this, std::move(value)}; }
+
+    recv_awaiter recv() { return recv_awaiter{*this}; }
+
+    // Non-suspending variants, usable from plain threads
+    bool try_send(T& value);
+
+    std::optional<T> try_recv();
+
+    // Wakes every suspended sender (with false) and receiver (with nullopt).
+    // Buffered values can still be received after close.
+    void close();
+
+    bool is_closed() {
+        std::lock_guard lock{this->guard};
+        return this->closed;
+    }
+
+private:
+    void push(T&& value) {
+        this->slots[(this->head + this->size) % this->slots.size()].emplace(std::move(value));
+        ++this->size;
+    }
+
+    T pop() {
+        auto& slot = this->slots[this->head];
+        T value = std::move(*slot);
+        slot.reset();
+        this->head = (this->head + 1) % this->slots.size();
+        --this->size;
+        return value;
+    }
+
+    std::mutex                    guard{};
+    std::vector<std::optional<T>> slots;
+    size_t                        head{0};
+    size_t                        size{0};
+    bool                          closed{false};
+    detail::waiter_list           senders{};
+    detail::waiter_list           receivers{};
+};
+
+template<typename T>
+bool channel<T>::try_send(T& value) {
+    detail::waiter* to_resume = nullptr;
+    {
+        std::lock_guard lock{this->guard};
+        if (this->closed) {
+            return false;
+        }
+        if (auto* r = this->receivers.pop_front(); r) {
+            static_cast<recv_awaiter*>(r)->value.emplace(std::move(value));
+            to_resume = r;
+        } else if (this->size < this->slots.size()) {
+            this->push(std::move(value));
+        } else {
+            return false;
+        }
+    }
+    if (to_resume) {
+        coro::thread::dispatch(to_resume->handle);
+    }
+    return true;
+}
+
+template<typename T>
+std::optional<T> channel<T>::try_recv() {
+    std::optional<T> value{};
+    detail::waiter* to_resume = nullptr;
+    {
+        std::lock_guard lock{this->guard};
+        if (this->size > 0) {
+            value.emplace(this->pop());
+            if (auto* s = this->senders.pop_front(); s) {
+                auto* sender = static_cast<send_awaiter*>(s);
+                this->push(std::move(sender->value));
+                sender->ok = true;
+                to_resume = s;
+            }
+        } else if (auto* s = this->senders.pop_front(); s) {
+            auto* sender = static_cast<send_awaiter*>(s);
+            value.emplace(std::move(sender->value));
+            sender->ok = true;
+            to_resume = s;
+        }
+    }
+    if (to_resume) {
+        coro::thread::dispatch(to_resume->handle);
+    }
+    return value;
+}
+
+template<typename T>
+void channel<T>::close() {
+    detail::waiter* ss;
+    detail::waiter* rs;
+    {
+        std::lock_guard lock{this->guard};
+        this->closed = true;
+        ss = this->senders.take_all();
+        rs = this->receivers.take_all();
+    }
+    detail::resume_all(ss);
+    detail::resume_all(rs);
+}
+
+}
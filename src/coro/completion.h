@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace coro {
+
+namespace detail {
+// Wakes a thread blocked on a task. It lives on the stack of that thread,
+// which only returns from wait() once raise() is done with it.
+class alignas(8) join_signal {
+public:
+    void raise() {
+        this->value.store(raised, std::memory_order_release);
+        this->value.notify_one();
+        this->value.store(released, std::memory_order_release);
+    }
+
+    void wait() {
+        uint32_t v;
+        while ((v = this->value.load(std::memory_order_acquire)) != released) {
+            if (v == waiting) {
+                this->value.wait(waiting, std::memory_order_acquire);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t waiting = 0;
+    static constexpr uint32_t raised = 1;
+    static constexpr uint32_t released = 2;
+
+    std::atomic<uint32_t> value{waiting};
+};
+
+// Completion state shared by the task promises.
+// The state is either nullptr (running), a continuation address, the
+// address of a join_signal tagged with its low bit, or the address of
+// the state itself once the coroutine is done.
+class completion_state {
+public:
+    // Returns false if the coroutine has already completed,
+    // in which case the caller should not suspend.
+    bool set_continuation(std::coroutine_handle<> h) {
+        void* expected = nullptr;
+        return this->state.compare_exchange_strong(
+            expected, h.address(),
+            std::memory_order_acq_rel,
+            std::memory_order_acquire
+        );
+    }
+
+    // Called from final_suspend, nothing in the frame may be touched
+    // after the exchange, since an owner that sees it done is free to
+    // destroy it. A blocked owner is woken through its own signal.
+    std::coroutine_handle<> complete() {
+        void* old = this->state.exchange(this->done_tag(), std::memory_order_acq_rel);
+        if (auto* signal = as_signal(old)) {
+            signal->raise();
+            return std::noop_coroutine();
+        }
+        if (old) {
+            return std::coroutine_handle<>::from_address(old);
+        }
+        return std::noop_coroutine();
+    }
+
+    bool is_done() const {
+        return this->state.load(std::memory_order_acquire) == this->done_tag();
+    }
+
+    // Blocks the calling thread until the coroutine completes
+    void wait() {
+        join_signal signal{};
+        void* expected = nullptr;
+        auto tagged = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(&signal) | 1);
+        if (this->state.compare_exchange_strong(
+            expected, tagged,
+            std::memory_order_acq_rel,
+            std::memory_order_acquire
+        )) {
+            signal.wait();
+            return;
+        }
+        // Either done already, or awaited by a coroutine while joined,
+        // which complete() only resumes, never waking anyone
+        while (!this->is_done()) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void* done_tag() const {
+        return const_cast<completion_state*>(this);
+    }
+
+    static join_signal* as_signal(void* state) {
+        auto bits = reinterpret_cast<uintptr_t>(state);
+        return bits & 1 ? reinterpret_cast<join_signal*>(bits & ~uintptr_t{1}) : nullptr;
+    }
+
+    std::atomic<void*> state{nullptr};
+};
+
+struct completion_awaiter {
+    bool await_ready() noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept {
+        return this->state->complete();
+    }
+    void await_resume() noexcept {}
+    completion_state* state;
+};
+}
+
+// Blocks the calling (non-coroutine) thread until the task completes,
+// and returns its result.
+template<typename task_t>
+decltype(auto) sync_wait(task_t&& task) {
+    return std::forward<task_t>(task).sync_wait();
+}
+
+}
@@ -1,9 +1,11 @@
 #pragma once
 #include <coroutine>
-#include <thread>
 #include <utility>
+#include "coro/completion.h"
 
 namespace coro{
+// Starts eagerly. Can be awaited once by another coroutine,
+// or joined from a plain thread with get() / sync_wait().
 template <typename return_t>
 class lazy_task{
 public:
@@ -17,7 +19,7 @@ public:
         }
 
         auto final_suspend() noexcept{
-            return std::suspend_always{};
+            return detail::completion_awaiter{&this->completion};
         }
         void unhandled_exception() {}
 
@@ -31,7 +33,22 @@ public:
         }
 
         return_t value;
+        detail::completion_state completion{};
     };
+
+    struct awaiter{
+        bool await_ready() { return this->handle.promise().completion.is_done(); }
+        bool await_suspend(std::coroutine_handle<> h) {
+            return this->handle.promise().completion.set_continuation(h);
+        }
+        return_t& await_resume() { return this->handle.promise().value; }
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    struct rvalue_awaiter : awaiter{
+        return_t await_resume() { return std::move(this->handle.promise().value); }
+    };
+
     explicit lazy_task(promise_type* p): handle{handle_type::from_promise(*p)}{}
     lazy_task(lazy_task&& other) = delete;
     lazy_task(const lazy_task& other) = delete;
@@ -39,28 +56,39 @@ public:
     lazy_task& operator=(const lazy_task& other) = delete;
 
     ~lazy_task(){
-        while (!handle.done())
-            std::this_thread::yield();
+        handle.promise().completion.wait();
         handle.destroy();
     }
 
     bool done() const{
-        return handle.done();
+        return handle.promise().completion.is_done();
+    }
+
+    awaiter operator co_await() & {
+        return awaiter{this->handle};
+    }
+
+    rvalue_awaiter operator co_await() && {
+        return rvalue_awaiter{{this->handle}};
     }
 
     return_t& get(){
-        while (!handle.done()){
-            std::this_thread::yield();
-        }
+        handle.promise().completion.wait();
         return handle.promise().value;
     }
 
     return_t&& get_as_rvalue(){
-        while (!handle.done()){
-            std::this_thread::yield();
-        }
+        handle.promise().completion.wait();
         return std::move(handle.promise().value);
     }
+
+    return_t& sync_wait() & {
+        return this->get();
+    }
+
+    return_t sync_wait() && {
+        return this->get_as_rvalue();
+    }
 private:
     using handle_type = std::coroutine_handle<promise_type>;
     handle_type handle;
@@ -79,12 +107,24 @@ public:
         }
 
         auto final_suspend() noexcept {
-            return std::suspend_always{};
+            return detail::completion_awaiter{&this->completion};
         }
         void unhandled_exception() {  }
 
         void return_void(){}
+
+        detail::completion_state completion{};
+    };
+
+    struct awaiter{
+        bool await_ready() { return this->handle.promise().completion.is_done(); }
+        bool await_suspend(std::coroutine_handle<> h) {
+            return this->handle.promise().completion.set_continuation(h);
+        }
+        void await_resume() {}
+        std::coroutine_handle<promise_type> handle;
     };
+
     explicit lazy_task(promise_type* p): handle{handle_type::from_promise(*p)}{}
     lazy_task(lazy_task&& other) = delete;
     lazy_task(const lazy_task& other) = delete;
@@ -92,15 +132,22 @@ public:
     lazy_task& operator=(const lazy_task& other) = delete;
 
     ~lazy_task(){
-        while (!handle.done())
-            std::this_thread::yield();
+        handle.promise().completion.wait();
         handle.destroy();
     }
 
     bool done() const{
-        return handle.done();
+        return handle.promise().completion.is_done();
+    }
+
+    awaiter operator co_await() {
+        return awaiter{this->handle};
     }
-    
+
+    void sync_wait() {
+        handle.promise().completion.wait();
+    }
+
 private:
     using handle_type = std::coroutine_handle<promise_type>;
     handle_type handle;
@@ -0,0 +1,78 @@
+#include "coro/offload.h"
+
+namespace coro::thread::detail {
+
+offload_pool& offload_pool::get_instance(){
+    static offload_pool instance{};
+    return instance;
+}
+
+
+void offload_pool::worker(std::stop_token st){
+    while (auto j = jobs.pop_front_wait([&]{ return st.stop_requested(); })) {
+
+        j->run(j->ctx);
+
+        this->depth.fetch_sub(1, std::memory_order_acq_rel);
+        this->completed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool offload_pool::init(size_t worker_count, size_t capacity) {
+    static bool flag = false;
+    if (flag || worker_count == 0 || capacity == 0) {
+        return false;
+    }
+    workers.reserve(worker_count);
+    for(size_t i = 0; i < worker_count; ++i){
+        workers.emplace_back([this](std::stop_token st){
+            this->worker(st);
+        });
+    }
+    // submissions start once the workers are there
+    this->capacity.store(capacity, std::memory_order_release);
+    flag = true;
+    return true;
+}
+
+bool offload_pool::try_submit(void* ctx, auto (*run)(void*) -> void) {
+    size_t capacity = this->capacity.load(std::memory_order_acquire);
+    if (capacity == 0) {
+        this->rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t d = this->depth.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (d > capacity) {
+        this->depth.fetch_sub(1, std::memory_order_acq_rel);
+        this->rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t max_d = this->max_depth.load(std::memory_order_relaxed);
+    while (d > max_d &&
+        !this->max_depth.compare_exchange_weak(max_d, d, std::memory_order_relaxed)) {}
+
+    this->submitted.fetch_add(1, std::memory_order_relaxed);
+    this->jobs.emplace_back(ctx, run);
+    return true;
+}
+
+offload_metrics offload_pool::metrics() const {
+    return {
+        this->depth.load(std::memory_order_relaxed),
+        this->max_depth.load(std::memory_order_relaxed),
+        this->submitted.load(std::memory_order_relaxed),
+        this->completed.load(std::memory_order_relaxed),
+        this->rejected.load(std::memory_order_relaxed)
+    };
+}
+
+offload_pool::~offload_pool() {
+    for (auto& worker : workers) {
+        worker.request_stop();
+    }
+    jobs.wake_all();
+}
+
+}
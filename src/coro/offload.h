@@ -0,0 +1,149 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/waitable_queue.h"
+#include "coro/thread.h"
+
+namespace coro::thread {
+
+struct offload_metrics {
+    size_t queue_depth;         // jobs queued or running on the offload pool
+    size_t max_queue_depth;     // high-water mark of queue_depth
+    size_t submitted;
+    size_t completed;
+    size_t rejected;            // jobs run inline because the pool was full or not initialized
+};
+
+namespace detail {
+// A bounded pool for blocking or cpu-heavy work, kept apart from the
+// io workers so that a slow handler does not stall the connections behind it.
+class offload_pool {
+public:
+    struct job {
+        void* ctx;
+        auto (*run)(void*) -> void;
+    };
+
+    static offload_pool& get_instance();
+
+    bool init(size_t worker_count, size_t capacity);
+
+    // Returns false if the pool is full or not initialized,
+    // the caller is expected to run the job by itself.
+    bool try_submit(void* ctx, auto (*run)(void*) -> void);
+
+    offload_metrics metrics() const;
+
+    offload_pool(const offload_pool&) = delete;
+    offload_pool(offload_pool&&) = delete;
+    offload_pool& operator=(const offload_pool&) = delete;
+    offload_pool& operator=(offload_pool&&) = delete;
+private:
+    void worker(std::stop_token st);
+
+    offload_pool() = default;
+    ~offload_pool();
+
+    concurrent::waitable_queue<concurrent::mpmc_queue<job>> jobs{};
+    std::vector<std::jthread> workers{};
+    // 0 until init() is done, read by submitters on any thread
+    std::atomic<size_t> capacity{0};
+
+    alignas(64) std::atomic<size_t> depth{0};
+    std::atomic<size_t> max_depth{0};
+    alignas(64) std::atomic<size_t> submitted{0};
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> rejected{0};
+};
+
+}
+
+inline bool init_offload(size_t worker_count, size_t capacity = 1024) {
+    return detail::offload_pool::get_instance().init(worker_count, capacity);
+}
+
+inline offload_metrics offload_stats() {
+    return detail::offload_pool::get_instance().metrics();
+}
+
+}
+
+namespace coro {
+
+// co_await coro::offload{[&]{ return Json::parse(body); }};
+// Runs the callable on the offload pool and resumes the awaiting
+// coroutine on an io worker through coro::thread::dispatch.
+template<typename invocable_t>
+    requires std::is_invocable_v<invocable_t&>
+class offload {
+public:
+    using result_t = std::invoke_result_t<invocable_t&>;
+
+    explicit offload(invocable_t fn) : fn(std::move(fn)) {}
+
+    bool await_ready() { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        this->handle = h;
+        if (thread::detail::offload_pool::get_instance().try_submit(this, &offload::run)) {
+            return true;
+        }
+        // Pool is saturated, fall back to running on the current worker
+        this->invoke();
+        return false;
+    }
+
+    result_t await_resume() {
+        if constexpr (std::is_reference_v<result_t>) {
+            return static_cast<result_t>(*this->result);
+        } else if constexpr (!std::is_void_v<result_t>) {
+            return std::move(*this->result);
+        }
+    }
+
+private:
+    void invoke() {
+        if constexpr (std::is_void_v<result_t>) {
+            std::invoke(this->fn);
+        } else if constexpr (std::is_reference_v<result_t>) {
+            this->result = std::addressof(std::invoke(this->fn));
+        } else {
+            this->result.emplace(std::invoke(this->fn));
+        }
+    }
+
+    static void run(void* ctx) {
+        auto* self = static_cast<offload*>(ctx);
+        self->invoke();
+        thread::dispatch(self->handle);
+    }
+
+    invocable_t fn;
+    std::coroutine_handle<> handle{};
+    // a reference result is kept as a pointer, std::optional<T&> is ill-formed
+    std::conditional_t<
+        std::is_void_v<result_t>,
+        std::monostate,
+        std::conditional_t<
+            std::is_reference_v<result_t>,
+            std::remove_reference_t<result_t>*,
+            std::optional<result_t>
+        >
+    > result{};
+};
+
+template<typename invocable_t>
+offload(invocable_t) -> offload<invocable_t>;
+
+}
@@ -0,0 +1,291 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include "coro/thread.h"
+
+// Synchronization primitives that suspend the awaiting coroutine instead
+// of the worker thread. Waiters are resumed through coro::thread::dispatch,
+// so the releasing side never runs foreign coroutines inline.
+// The internal std::mutex only guards the waiter list for a few instructions.
+
+namespace coro {
+
+namespace detail {
+struct waiter {
+    std::coroutine_handle<> handle{};
+    waiter*                 next{nullptr};
+};
+
+class waiter_list {
+public:
+    bool empty() const { return this->head == nullptr; }
+
+    void push_back(waiter* w) {
+        w->next = nullptr;
+        if (this->tail) {
+            this->tail->next = w;
+        } else {
+            this->head = w;
+        }
+        this->tail = w;
+    }
+
+    waiter* pop_front() {
+        waiter* w = this->head;
+        if (w) {
+            this->head = w->next;
+            if (!this->head) {
+                this->tail = nullptr;
+            }
+        }
+        return w;
+    }
+
+    // Detach the whole list, useful to resume all waiters outside of the lock
+    waiter* take_all() {
+        waiter* w = this->head;
+        this->head = this->tail = nullptr;
+        return w;
+    }
+private:
+    waiter* head{nullptr};
+    waiter* tail{nullptr};
+};
+
+inline void resume_all(waiter* w) {
+    while (w) {
+        // the waiter may be destroyed as soon as it is resumed
+        auto* next = w->next;
+        coro::thread::dispatch(w->handle);
+        w = next;
+    }
+}
+}
+
+class async_mutex;
+
+class async_lock_guard {
+public:
+    async_lock_guard() = default;
+    explicit async_lock_guard(async_mutex& m) : mutex(&m) {}
+    async_lock_guard(const async_lock_guard&) = delete;
+    async_lock_guard& operator=(const async_lock_guard&) = delete;
+    async_lock_guard(async_lock_guard&& other) noexcept
+        : mutex(std::exchange(other.mutex, nullptr)) {}
+    async_lock_guard& operator=(async_lock_guard&& other) noexcept {
+        if (this != &other) {
+            this->unlock();
+            this->mutex = std::exchange(other.mutex, nullptr);
+        }
+        return *this;
+    }
+    ~async_lock_guard() { this->unlock(); }
+
+    inline void unlock();
+private:
+    async_mutex* mutex{nullptr};
+};
+
+class async_mutex {
+public:
+    struct lock_awaiter : detail::waiter {
+        bool await_ready() { return this->m.try_lock(); }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            std::lock_guard lock{this->m.guard};
+            if (!this->m.locked) {
+                this->m.locked = true;
+                return false;
+            }
+            this->m.waiters.push_back(this);
+            return true;
+        }
+
+        void await_resume() {}
+
+        explicit lock_awaiter(async_mutex& m) : m(m) {}
+        async_mutex& m;
+    };
+
+    struct scoped_lock_awaiter : lock_awaiter {
+        using lock_awaiter::lock_awaiter;
+        async_lock_guard await_resume() { return async_lock_guard{this->m}; }
+    };
+
+    async_mutex() = default;
+    async_mutex(const async_mutex&) = delete;
+    async_mutex(async_mutex&&) = delete;
+    async_mutex& operator=(const async_mutex&) = delete;
+    async_mutex& operator=(async_mutex&&) = delete;
+
+    bool try_lock() {
+        std::lock_guard lock{this->guard};
+        if (this->locked) {
+            return false;
+        }
+        this->locked = true;
+        return true;
+    }
+
+    // co_await m.lock(); ... m.unlock();
+    lock_awaiter lock() { return lock_awaiter{*this}; }
+
+    // auto guard = co_await m.scoped_lock();
+    scoped_lock_awaiter scoped_lock() { return scoped_lock_awaiter{*this}; }
+
+    void unlock() {
+        detail::waiter* next;
+        {
+            std::lock_guard lock{this->guard};
+            next = this->waiters.pop_front();
+            if (!next) {
+                this->locked = false;
+                return;
+            }
+        }
+        // ownership is handed over to the next waiter, the mutex stays locked
+        coro::thread::dispatch(next->handle);
+    }
+
+private:
+    std::mutex          guard{};
+    bool                locked{false};
+    detail::waiter_list waiters{};
+};
+
+inline void async_lock_guard::unlock() {
+    if (this->mutex) {
+        std::exchange(this->mutex, nullptr)->unlock();
+    }
+}
+
+
+class async_semaphore {
+public:
+    struct acquire_awaiter : detail::waiter {
+        bool await_ready() { return this->s.try_acquire(); }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            std::lock_guard lock{this->s.guard};
+            if (this->s.count > 0) {
+                --this->s.count;
+                return false;
+            }
+            this->s.waiters.push_back(this);
+            return true;
+        }
+
+        void await_resume() {}
+
+        explicit acquire_awaiter(async_semaphore& s) : s(s) {}
+        async_semaphore& s;
+    };
+
+    explicit async_semaphore(size_t initial = 0) : count(initial) {}
+    async_semaphore(const async_semaphore&) = delete;
+    async_semaphore(async_semaphore&&) = delete;
+    async_semaphore& operator=(const async_semaphore&) = delete;
+    async_semaphore& operator=(async_semaphore&&) = delete;
+
+    bool try_acquire() {
+        std::lock_guard lock{this->guard};
+        if (this->count == 0) {
+            return false;
+        }
+        --this->count;
+        return true;
+    }
+
+    acquire_awaiter acquire() { return acquire_awaiter{*this}; }
+
+    void release(size_t n = 1) {
+        detail::waiter_list woken{};
+        {
+            std::lock_guard lock{this->guard};
+            for (; n > 0; --n) {
+                if (auto* w = this->waiters.pop_front(); w) {
+                    woken.push_back(w); // permit is transferred to the waiter
+                } else {
+                    this->count += n;
+                    break;
+                }
+            }
+        }
+        detail::resume_all(woken.take_all());
+    }
+
+    size_t available() {
+        std::lock_guard lock{this->guard};
+        return this->count;
+    }
+
+private:
+    std::mutex          guard{};
+    size_t              count;
+    detail::waiter_list waiters{};
+};
+
+
+// Manual-reset event
+class async_event {
+public:
+    struct wait_awaiter : detail::waiter {
+        bool await_ready() { return this->e.is_set(); }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            std::lock_guard lock{this->e.guard};
+            if (this->e.flag) {
+                return false;
+            }
+            this->e.waiters.push_back(this);
+            return true;
+        }
+
+        void await_resume() {}
+
+        explicit wait_awaiter(async_event& e) : e(e) {}
+        async_event& e;
+    };
+
+    explicit async_event(bool initially_set = false) : flag(initially_set) {}
+    async_event(const async_event&) = delete;
+    async_event(async_event&&) = delete;
+    async_event& operator=(const async_event&) = delete;
+    async_event& operator=(async_event&&) = delete;
+
+    bool is_set() {
+        std::lock_guard lock{this->guard};
+        return this->flag;
+    }
+
+    wait_awaiter wait() { return wait_awaiter{*this}; }
+
+    wait_awaiter operator co_await() { return wait_awaiter{*this}; }
+
+    void set() {
+        detail::waiter* ws;
+        {
+            std::lock_guard lock{this->guard};
+            this->flag = true;
+            ws = this->waiters.take_all();
+        }
+        detail::resume_all(ws);
+    }
+
+    void reset() {
+        std::lock_guard lock{this->guard};
+        this->flag = false;
+    }
+
+private:
+    std::mutex          guard{};
+    bool                flag;
+    detail::waiter_list waiters{};
+};
+
+}
@@ -1,6 +1,9 @@
 #include "coro/thread.h"
+#include <algorithm>
 #include <exception>
+#include <optional>
 #include <print>
+#include "logging/log.h"
 
 namespace coro::thread::detail {
 
@@ -10,36 +13,157 @@ pool& pool::get_instance(){
 } 
 
 
-void pool::worker(std::stop_token st){
-    while(sem.acquire(), !st.stop_requested()){
-        
-        auto h = tasks.pop_front();
+void pool::run_slice(std::coroutine_handle<> h){
+    auto& s = current_slice;
+    s.start = clock::now();
+    s.ops = 0;
 
-        h->resume();
+    h.resume();
+
+    this->slices.fetch_add(1, std::memory_order_relaxed);
+    if (clock::now() - s.start >= clock::duration{this->time_slice.load(std::memory_order_relaxed)}) {
+        this->long_slices.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void pool::worker(std::stop_token st, worker_t& self){
+    current_slice.in_worker = true;
+    // Claims a token left by retire_worker, only checked while idle
+    auto retired = [this]{
+        size_t tokens = this->retire_tokens.load(std::memory_order_relaxed);
+        return tokens > 0 && this->retire_tokens.compare_exchange_strong(tokens, tokens - 1, std::memory_order_acq_rel);
+    };
+    while (!st.stop_requested()) {
+        std::optional<task_t> t{};
+#ifdef CORO_POOL_RING_CAPACITY
+        if (!overflow.empty()) {
+            t = overflow.front();
+            overflow.pop_front();
+        }
+#endif
+        if (!t) {
+            t = tasks.pop_front_wait([&]{ return st.stop_requested() || retired(); });
+        }
+        if (!t) {
+            break;
+        }
+        if (t->enqueued != clock::time_point{}) {
+            this->pending.fetch_sub(1, std::memory_order_relaxed);
+            this->queue_delay.fetch_add((clock::now() - t->enqueued).count(), std::memory_order_relaxed);
+        }
+
+        this->run_slice(t->handle);
     }
+    this->worker_count.fetch_sub(1, std::memory_order_acq_rel);
+    self.exited.store(true, std::memory_order_release);
+}
+
+void pool::spawn_worker(){
+    auto& w = *workers.emplace_back(std::make_unique<worker_t>());
+    this->worker_count.fetch_add(1, std::memory_order_acq_rel);
+    w.thread = std::jthread([this, &w](std::stop_token st){
+        this->worker(st, w);
+    });
+}
+
+void pool::retire_worker(){
+    this->retire_tokens.fetch_add(1, std::memory_order_acq_rel);
+    this->tasks.wake_all();
 }
+
 bool pool::init(size_t worker_count) {
-    static bool flag = false;
-    if (flag) {
+    if (this->initialized) {
         return false;
     }
     workers.reserve(worker_count);
     for(size_t i = 0; i < worker_count; ++i){
-        workers.emplace_back([this](std::stop_token st){
-            this->worker(st);
-        });
+        this->spawn_worker();
     }
-    flag = true;
+    this->initialized = true;
     return true;
 }
 
+bool pool::init_elastic(const elastic_config& config) {
+    if (config.min_workers == 0 || config.min_workers > config.max_workers) {
+        return false;
+    }
+    // handles submitted before this stay unstamped, the workers tell them apart
+    this->elastic.store(true, std::memory_order_relaxed);
+    if (!this->init(config.min_workers)) {
+        this->elastic.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    this->controller = std::jthread([this, config](std::stop_token st){
+        this->control(st, config);
+    });
+    return true;
+}
+
+void pool::control(std::stop_token st, elastic_config config){
+    size_t overloaded_intervals = 0;
+    size_t idle_intervals = 0;
+    auto last = this->metrics();
+
+    std::unique_lock lock{this->controller_mutex};
+    while (!st.stop_requested()) {
+        this->controller_cv.wait_for(lock, st, config.interval, []{ return false; });
+        if (st.stop_requested()) {
+            break;
+        }
+
+        // Reap workers that have been retired
+        std::erase_if(this->workers, [](const std::unique_ptr<worker_t>& w){
+            return w->exited.load(std::memory_order_acquire);
+        });
+
+        auto now = this->metrics();
+        size_t ran = now.slices - last.slices;
+        clock::duration avg_delay = ran ? (now.queue_delay - last.queue_delay) / static_cast<clock::rep>(ran) : clock::duration::zero();
+        last = now;
+
+        // No progress while handles are queued means every worker is blocked
+        bool overloaded = (ran && avg_delay >= config.grow_delay) || (now.pending > 0 && ran == 0);
+        bool idle = now.pending == 0 && avg_delay <= config.idle_delay;
+
+        overloaded_intervals = overloaded ? overloaded_intervals + 1 : 0;
+        idle_intervals = idle ? idle_intervals + 1 : 0;
+
+        size_t live = now.workers - this->retire_tokens.load(std::memory_order_acquire);
+
+        if (overloaded_intervals >= config.grow_after && live < config.max_workers) {
+            this->spawn_worker();
+            overloaded_intervals = 0;
+            logging::async::info("coro pool grows to {} workers, queue delay {}", live + 1, avg_delay);
+        } else if (idle_intervals >= config.shrink_after && live > config.min_workers) {
+            this->retire_worker();
+            idle_intervals = 0;
+            logging::async::info("coro pool shrinks to {} workers", live - 1);
+        }
+    }
+}
+
+scheduler_metrics pool::metrics() const {
+    return {
+        this->slices.load(std::memory_order_relaxed),
+        this->long_slices.load(std::memory_order_relaxed),
+        this->yields.load(std::memory_order_relaxed),
+        this->pending.load(std::memory_order_relaxed),
+        this->worker_count.load(std::memory_order_relaxed),
+        clock::duration{this->queue_delay.load(std::memory_order_relaxed)}
+    };
+}
+
 pool::~pool() {
+    this->controller.request_stop();
+    if (this->controller.joinable()) {
+        this->controller.join();
+    }
     for (auto& worker : workers) {
-        worker.request_stop();
+        worker->thread.request_stop();
     }
-    sem.release(workers.size());
+    tasks.wake_all();
 }
 
 
 
-}
\ No newline at end of file
+}
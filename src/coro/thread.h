@@ -1,38 +1,210 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
-#include <semaphore>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
 #include <thread>
 #include <coroutine>
 #include <vector>
 #include "concurrent/mpmc_queue.h"
+#include "concurrent/mpmc_ringbuffer.h"
+#include "concurrent/waitable_queue.h"
 namespace coro::thread {
-    
+
+using clock = std::chrono::steady_clock;
+
+struct scheduler_metrics {
+    size_t          slices;         // coroutine resumptions run by the workers
+    size_t          long_slices;    // resumptions that ran longer than the time slice
+    size_t          yields;         // maybe_yield() calls that actually rescheduled
+    size_t          pending;        // handles waiting in the run queue, elastic mode only
+    size_t          workers;        // live workers
+    clock::duration queue_delay;    // total time handles spent in the run queue, elastic mode only
+};
+
+// Elastic mode: the pool grows when handles wait in the run queue for too
+// long (e.g. handlers blocking in foreign code), and shrinks back after a
+// period of idleness. Both directions need several consecutive intervals
+// to agree before acting.
+struct elastic_config {
+    size_t          min_workers{2};
+    // hardware_concurrency() may be 0, and the default may not go below min_workers
+    size_t          max_workers{std::max(2u, std::thread::hardware_concurrency())};
+    clock::duration interval{std::chrono::milliseconds(10)};
+    clock::duration grow_delay{std::chrono::milliseconds(1)};      // average queue delay that counts as overloaded
+    clock::duration idle_delay{std::chrono::microseconds(50)};     // average queue delay that counts as idle
+    size_t          grow_after{3};      // consecutive overloaded intervals before adding a worker
+    size_t          shrink_after{500};  // consecutive idle intervals before retiring a worker
+};
+
 namespace detail {
+
+// Execution budget of the coroutine currently running on this worker.
+// A slice starts each time a worker resumes a coroutine.
+struct slice_t {
+    clock::time_point start{};
+    size_t            ops{0};
+    bool              in_worker{false};
+};
+
+inline thread_local slice_t current_slice{};
+
 class pool {
 public:
     static pool& get_instance();
 
+    // A pool apart from the process wide one, only meant for tests
+    pool() = default;
+    ~pool();
+
     void submit(std::coroutine_handle<> h){
-        tasks.emplace_back(h);
-        sem.release();
+        auto now = this->stamp(1);
+#ifdef CORO_POOL_RING_CAPACITY
+        this->push(h, now);
+#else
+        tasks.emplace_back(h, now);
+#endif
+    }
+
+    void submit_bulk(std::span<const std::coroutine_handle<>> handles){
+        if (handles.empty()) {
+            return;
+        }
+        auto now = this->stamp(handles.size());
+#ifdef CORO_POOL_RING_CAPACITY
+        for (auto h : handles) {
+            this->push(h, now);
+        }
+#else
+        tasks.emplace_back_bulk(handles | std::views::transform([now](std::coroutine_handle<> h) {
+            return task_t{h, now};
+        }));
+#endif
     }
 
     bool init(size_t worker_count);
 
+    bool init_elastic(const elastic_config& config);
+
+    void set_budget(clock::duration time_slice, size_t op_budget) {
+        this->time_slice.store(time_slice.count(), std::memory_order_relaxed);
+        this->op_budget.store(op_budget, std::memory_order_relaxed);
+    }
+
+    // Cheap enough to be called on every loop iteration, the clock is only
+    // read once every `clock_check_interval` ops.
+    bool slice_exhausted() {
+        auto& s = current_slice;
+        if (!s.in_worker) {
+            return false;
+        }
+        size_t budget = this->op_budget.load(std::memory_order_relaxed);
+        if (++s.ops >= budget && budget != 0) {
+            return true;
+        }
+        if (s.ops % clock_check_interval != 0) {
+            return false;
+        }
+        return clock::now() - s.start >= clock::duration{this->time_slice.load(std::memory_order_relaxed)};
+    }
+
+    void count_yield() {
+        this->yields.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    scheduler_metrics metrics() const;
+
+    // Worker threads not reaped yet, retired ones included, meant for tests
+    size_t threads() {
+        std::lock_guard lock{this->controller_mutex};
+        return this->workers.size();
+    }
+
     pool(const pool&) = delete;        
     pool(pool&&) = delete;
     pool& operator=(const pool&) = delete;
     pool& operator=(pool&&) = delete;
 private:        
+    static constexpr size_t clock_check_interval = 64;
+
+    struct task_t {
+        std::coroutine_handle<> handle;
+        clock::time_point       enqueued;
+    };
 
-    void worker(std::stop_token st);
+    struct worker_t {
+        std::jthread      thread{};
+        std::atomic<bool> exited{false};
+    };
 
-    pool() = default;        
-    ~pool();  
+    void worker(std::stop_token st, worker_t& self);
 
-    concurrent::mpmc_queue<std::coroutine_handle<>> tasks{};        
-    std::vector<std::jthread> workers{};
-    std::counting_semaphore<> sem{0};
+    // Only the elastic controller looks at the run queue, so a fixed pool
+    // leaves handles unstamped and its workers skip the shared counters
+    clock::time_point stamp(size_t count) {
+        if (!this->elastic.load(std::memory_order_relaxed)) {
+            return {};
+        }
+        this->pending.fetch_add(count, std::memory_order_relaxed);
+        return clock::now();
+    }
+
+#ifdef CORO_POOL_RING_CAPACITY
+    // Workers are the ones draining the ring, so they never block on it:
+    // what does not fit goes to the worker's own overflow list, which it
+    // runs ahead of the ring. Other threads wait for a free slot.
+    void push(std::coroutine_handle<> h, clock::time_point now) {
+        if (!current_slice.in_worker) {
+            tasks.emplace_back(h, now);
+        } else if (!tasks.try_emplace_back(h, now)) {
+            overflow.emplace_back(h, now);
+        }
+    }
+#endif
+
+    void run_slice(std::coroutine_handle<> h);
+
+    void spawn_worker();
+
+    // Asks one worker to exit the next time it wakes up
+    void retire_worker();
+
+    void control(std::stop_token st, elastic_config config);
+
+    // CORO_POOL_RING_CAPACITY switches the run queue to the bounded ring,
+    // submit from outside the pool then blocks while the ring is full.
+#ifdef CORO_POOL_RING_CAPACITY
+    concurrent::waitable_queue<concurrent::mpmc_ringbuffer<task_t, CORO_POOL_RING_CAPACITY>> tasks{};
+    static inline thread_local std::deque<task_t> overflow{};
+#else
+    concurrent::waitable_queue<concurrent::mpmc_queue<task_t>> tasks{};
+#endif
+    bool initialized{false};
+    std::vector<std::unique_ptr<worker_t>> workers{};
+    std::jthread controller{};
+    std::mutex controller_mutex{};
+    std::condition_variable_any controller_cv{};
+
+    std::atomic<bool> elastic{false};
+    alignas(64) std::atomic<size_t> pending{0};
+    alignas(64) std::atomic<size_t> worker_count{0};
+    std::atomic<size_t> retire_tokens{0};
+    alignas(64) std::atomic<clock::rep> queue_delay{0};
+
+    std::atomic<clock::rep> time_slice{
+        std::chrono::duration_cast<clock::duration>(std::chrono::milliseconds(2)).count()
+    };
+    std::atomic<size_t> op_budget{4096};
+
+    alignas(64) std::atomic<size_t> slices{0};
+    std::atomic<size_t> long_slices{0};
+    std::atomic<size_t> yields{0};
 };
 
 }
@@ -41,10 +213,29 @@ inline void dispatch(std::coroutine_handle<> handle) {
     detail::pool::get_instance().submit(handle);
 }
 
+// One queue reservation and at most one wake-up for the whole batch
+inline void dispatch_bulk(std::span<const std::coroutine_handle<>> handles) {
+    detail::pool::get_instance().submit_bulk(handles);
+}
+
 inline bool init(size_t worker_count) {
     return detail::pool::get_instance().init(worker_count);
 }
 
+inline bool init_elastic(const elastic_config& config = {}) {
+    return detail::pool::get_instance().init_elastic(config);
+}
+
+// Time slice and op budget used by coro::maybe_yield(), an op budget of 0
+// leaves only the time slice
+inline void set_budget(clock::duration time_slice, size_t op_budget) {
+    detail::pool::get_instance().set_budget(time_slice, op_budget);
+}
+
+inline scheduler_metrics metrics() {
+    return detail::pool::get_instance().metrics();
+}
+
 
 struct dispatch_awaiter{
     bool await_ready() { return false; }
@@ -60,6 +251,25 @@ struct dispatch_awaiter{
 
 }
 
+namespace coro {
+
+// co_await coro::maybe_yield();
+// Reschedules the coroutine only once its time slice or op budget on the
+// current worker is exhausted, otherwise it continues without suspending.
+struct maybe_yield {
+    bool await_ready() {
+        return !thread::detail::pool::get_instance().slice_exhausted();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        thread::detail::pool::get_instance().count_yield();
+        thread::dispatch(handle);
+    }
+
+    void await_resume() {}
+};
+
+}
 
 
 
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "http/http.h"
+#include "http/scan.h"
+
+namespace http {
+
+namespace {
+
+constexpr int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// ASCII bytes a form encoded string carries as they are
+constexpr auto form_plain_chars = [] {
+    std::array<char, 126> chars{};
+    size_t size = 0;
+    for (int c = 0; c < 0x80; ++c) {
+        if (c != '%' && c != '+') {
+            chars[size++] = static_cast<char>(c);
+        }
+    }
+    return chars;
+}();
+constexpr scan::char_set form_plain{{form_plain_chars.data(), form_plain_chars.size()}};
+
+template<bool plus_as_space>
+const char* find_escape(const char* first, const char* last) {
+    if constexpr (plus_as_space) {
+        // the set only covers ASCII, other bytes stop the scan as well
+        while ((first = scan::skip(first, last, form_plain)) != last && *first != '%' && *first != '+') {
+            ++first;
+        }
+        return first;
+    } else {
+        return scan::find_byte(first, last, '%');
+    }
+}
+
+template<bool plus_as_space>
+std::string_view decode(std::string_view str, std::string& buffer, std::error_code& ec) {
+    const char* first = str.data();
+    const char* last = str.data() + str.size();
+    const char* next = find_escape<plus_as_space>(first, last);
+    if (next == last) {
+        return str;
+    }
+
+    // decoding only ever shrinks, so the output is written in place and
+    // cut to size at the end
+    bool valid = true;
+    buffer.resize_and_overwrite(str.size(), [&](char* out_first, size_t) {
+        char* out = out_first;
+        while (true) {
+            out = std::copy(first, next, out);
+            if (next == last) {
+                break;
+            }
+            if (plus_as_space && *next == '+') {
+                *out++ = ' ';
+                first = next + 1;
+            } else {
+                int hi = last - next >= 3 ? hex_value(next[1]) : -1;
+                int lo = last - next >= 3 ? hex_value(next[2]) : -1;
+                if (hi < 0 || lo < 0) {
+                    valid = false;
+                    break;
+                }
+                *out++ = static_cast<char>(hi << 4 | lo);
+                first = next + 3;
+            }
+            // escaped UTF-8 comes in runs of escapes, not worth a scan each
+            next = first != last && *first == '%' ? first : find_escape<plus_as_space>(first, last);
+        }
+        return static_cast<size_t>(out - out_first);
+    });
+    if (!valid) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return {};
+    }
+    return buffer;
+}
+
+} // namespace
+
+std::string_view pct_decode(std::string_view str, std::string& buffer, std::error_code& ec) {
+    return decode<false>(str, buffer, ec);
+}
+
+std::string_view form_decode(std::string_view str, std::string& buffer, std::error_code& ec) {
+    return decode<true>(str, buffer, ec);
+}
+
+void query_params::iterator::next() {
+    this->done = true;
+    while (this->more) {
+        auto amp = scan::find_byte(this->rest, '&');
+        auto pair = this->rest.substr(0, amp);
+        if (amp == std::string_view::npos) {
+            this->more = false;
+            this->rest = {};
+        } else {
+            this->rest.remove_prefix(amp + 1);
+        }
+        if (pair.empty()) {
+            continue;   // a=1&&b=2
+        }
+        if (auto eq = scan::find_byte(pair, '='); eq == std::string_view::npos) {
+            this->current = {pair, {}};
+        } else {
+            this->current = {pair.substr(0, eq), pair.substr(eq + 1)};
+        }
+        this->done = false;
+        return;
+    }
+}
+
+std::optional<std::string_view> query_params::raw(std::string_view key) const {
+    std::string buffer{};
+    for (const auto& param : *this) {
+        // decoding never makes a key longer
+        if (param.key.size() < key.size()) {
+            continue;
+        }
+        std::error_code ec;
+        if (form_decode(param.key, buffer, ec) == key && !ec) {
+            return param.value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> query_params::get(std::string_view key, std::string& buffer) const {
+    auto value = this->raw(key);
+    if (!value) {
+        return std::nullopt;
+    }
+    std::error_code ec;
+    auto decoded = form_decode(*value, buffer, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return decoded;
+}
+
+} // namespace http
@@ -1,13 +1,18 @@
 #pragma once
 #include <charconv>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
 
 namespace http {
+// A string is no sentinel here, pct_decode("...", buffer, ec) means the
+// overload below
 template <std::forward_iterator It, std::sentinel_for<It> Sent>
-    requires std::same_as<std::iter_value_t<It>, char>
+    requires std::same_as<std::iter_value_t<It>, char> && (!std::same_as<Sent, std::string>)
 std::string pct_decode(It first, Sent last, std::error_code& ec) {
     std::string result;
 
@@ -59,6 +64,87 @@ template <std::ranges::forward_range R>
 auto pct_decode(R&& range, std::error_code& ec) {
     return pct_decode(std::ranges::begin(range), std::ranges::end(range), ec);
 }
+
+// Without any '%' in `str` the result is `str` itself and nothing is
+// allocated. Otherwise `str` is decoded into `buffer`, the runs between
+// escapes found by the vector scan and copied whole, and the result points
+// into it. Malformed escapes set `ec` and give an empty result.
+std::string_view pct_decode(std::string_view str, std::string& buffer, std::error_code& ec);
+
+// As pct_decode(), with '+' standing for a space as in form encoded queries
+std::string_view form_decode(std::string_view str, std::string& buffer, std::error_code& ec);
+
+// Lazy view over the `key=value` pairs of a query, separated by '&'. Nothing
+// is split or decoded up front: pairs are found by scanning as the view is
+// iterated, and keys and values stay encoded until asked for.
+class query_params {
+public:
+    // still encoded, `value` is empty for a key without '='
+    struct param {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    class iterator {
+    public:
+        using value_type = param;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::string_view rest) : rest(rest), more(!rest.empty()) {
+            this->next();
+        }
+
+        const param& operator*() const { return this->current; }
+        const param* operator->() const { return &this->current; }
+
+        iterator& operator++() {
+            this->next();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto it = *this;
+            this->next();
+            return it;
+        }
+
+        bool operator==(std::default_sentinel_t) const { return this->done; }
+        bool operator==(const iterator& other) const {
+            return this->done == other.done
+                && (this->done || this->current.key.data() == other.current.key.data());
+        }
+
+    private:
+        void next();
+
+        std::string_view rest{};
+        param            current{};
+        // `rest` may hold more pairs / `current` is past the last one
+        bool             more{false};
+        bool             done{true};
+    };
+
+    query_params() = default;
+    explicit query_params(std::string_view query) : query(query) {}
+
+    iterator begin() const { return iterator{this->query}; }
+    std::default_sentinel_t end() const { return {}; }
+
+    // Encoded value of the first pair whose decoded key is `key`
+    std::optional<std::string_view> raw(std::string_view key) const;
+
+    // Decoded value of the first pair whose decoded key is `key`, a view
+    // into the query unless it had escapes, then into `buffer`. A value
+    // that fails to decode is left out like a missing one.
+    std::optional<std::string_view> get(std::string_view key, std::string& buffer) const;
+
+    bool contains(std::string_view key) const {
+        return this->raw(key).has_value();
+    }
+
+private:
+    std::string_view query{};
+};
 } // namespace http
 
 #include "http/request.h"
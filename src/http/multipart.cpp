@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <cstring>
+
+#include "http/multipart.h"
+#include "http/scan.h"
+
+namespace http::multipart {
+
+namespace {
+
+constexpr std::string_view CRLF = "\r\n";
+constexpr std::string_view WS = " \t";
+
+// RFC 2046 bchars, none of them a CR, which the boundary search relies on
+constexpr scan::char_set bchars{
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz'()+_,-./:=? "
+};
+
+constexpr std::string_view trim(std::string_view in) {
+    auto first = in.find_first_not_of(WS);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return in.substr(first, in.find_last_not_of(WS) - first + 1);
+}
+
+struct param {
+    std::string_view key;
+    std::string_view value;
+};
+
+// Next `; key=value` of a header value past its first token, quoted values
+// come without their quotes and with their escapes left in
+std::optional<param> next_param(std::string_view& rest) {
+    rest.remove_prefix(std::min(rest.find_first_not_of("; \t"), rest.size()));
+    auto eq = rest.find('=');
+    if (rest.empty() || eq == std::string_view::npos) {
+        return std::nullopt;
+    }
+    auto key = trim(rest.substr(0, eq));
+    rest.remove_prefix(eq + 1);
+    rest.remove_prefix(std::min(rest.find_first_not_of(WS), rest.size()));
+
+    if (rest.starts_with('"')) {
+        size_t i = 1;
+        while (i < rest.size() && rest[i] != '"') {
+            i += rest[i] == '\\' ? 2 : 1;
+        }
+        if (i >= rest.size()) {
+            return std::nullopt;
+        }
+        auto value = rest.substr(1, i - 1);
+        rest.remove_prefix(i + 1);
+        return param{key, value};
+    }
+    auto end = std::min(rest.find(';'), rest.size());
+    auto value = trim(rest.substr(0, end));
+    rest.remove_prefix(end);
+    return param{key, value};
+}
+
+} // namespace
+
+std::optional<std::string_view> boundary(std::string_view content_type) {
+    auto rest = content_type.substr(std::min(content_type.find(';'), content_type.size()));
+    auto type = trim(content_type.substr(0, content_type.size() - rest.size()));
+    if (type.size() <= 10 || !request::iequals(type.substr(0, 10), "multipart/")) {
+        return std::nullopt;
+    }
+    while (auto p = next_param(rest)) {
+        if (!request::iequals(p->key, "boundary")) {
+            continue;
+        }
+        if (p->value.empty() || p->value.size() > 70 || p->value.ends_with(' ')
+            || scan::span(p->value, bchars) != p->value.size()) {
+            return std::nullopt;
+        }
+        return p->value;
+    }
+    return std::nullopt;
+}
+
+parser::parser(std::string_view boundary, multipart::limits limit)
+    : limit(limit),
+      delimiter(std::string{CRLF} + "--" + std::string{boundary}),
+      // the first boundary may start the body, without a CRLF ahead of it
+      carry(CRLF)
+{}
+
+parser::event parser::next(std::string_view& input) {
+    while (true) {
+        std::optional<event> ev{};
+        switch (this->current_state) {
+            case state::preamble:
+                ev = this->on_body(input, false);
+                break;
+            case state::data:
+                ev = this->on_body(input, true);
+                break;
+            case state::after_boundary:
+                ev = this->on_after_boundary(input);
+                break;
+            case state::headers:
+                ev = this->on_headers(input);
+                break;
+            case state::done:
+                input = {};
+                return {done};
+            case state::failed:
+                return {failed};
+        }
+        if (ev) {
+            return *ev;
+        }
+    }
+}
+
+// First place in `input` the delimiter starts at, either whole or cut off
+// by the end of `input`. Candidates are the CRs, found by the vector scan.
+parser::match parser::find_delimiter(std::string_view input) const {
+    const char* first = input.data();
+    const char* last = input.data() + input.size();
+    while ((first = scan::find_byte(first, last, '\r')) != last) {
+        size_t size = std::min(this->delimiter.size(), static_cast<size_t>(last - first));
+        if (std::memcmp(first, this->delimiter.data(), size) == 0) {
+            return {static_cast<size_t>(first - input.data()), size == this->delimiter.size()};
+        }
+        ++first;
+    }
+    return {std::string_view::npos, false};
+}
+
+// The preamble and the body of a part, only the latter is handed out
+std::optional<parser::event> parser::on_body(std::string_view& input, bool emit) {
+    auto on_delimiter = [&]() -> std::optional<event> {
+        this->current_state = state::after_boundary;
+        this->line.clear();
+        return emit ? std::optional<event>{{part_end}} : std::nullopt;
+    };
+
+    if (!this->carry.empty()) {
+        size_t missing = this->delimiter.size() - this->carry.size();
+        size_t size = std::min(missing, input.size());
+        if (input.substr(0, size) == std::string_view{this->delimiter}.substr(this->carry.size(), size)) {
+            if (size < missing) {
+                this->carry.append(input);
+                input = {};
+                return event{need_more};
+            }
+            input.remove_prefix(size);
+            this->carry.clear();
+            return on_delimiter();
+        }
+        // the delimiter has no CR but its first byte, so no later byte of
+        // the carry can start one either: all of it is data
+        this->spill.swap(this->carry);
+        this->carry.clear();
+        return emit ? std::optional<event>{{data, this->spill}} : std::nullopt;
+    }
+
+    if (input.empty()) {
+        return event{need_more};
+    }
+    auto [pos, full] = this->find_delimiter(input);
+    if (pos == std::string_view::npos || pos > 0) {
+        auto piece = input.substr(0, pos);
+        input.remove_prefix(piece.size());
+        return emit ? std::optional<event>{{data, piece}} : std::nullopt;
+    }
+    if (!full) {
+        this->carry.assign(input);
+        input = {};
+        return event{need_more};
+    }
+    input.remove_prefix(this->delimiter.size());
+    return on_delimiter();
+}
+
+// Either "--" closing the body, or optional padding and CRLF before a part
+std::optional<parser::event> parser::on_after_boundary(std::string_view& input) {
+    while (!input.empty()) {
+        this->line.push_back(input.front());
+        input.remove_prefix(1);
+        if (this->line == "--") {
+            this->current_state = state::done;
+            return event{done};
+        }
+        if (this->line.ends_with(CRLF)) {
+            if (!trim(std::string_view{this->line}.substr(0, this->line.size() - CRLF.size())).empty()) {
+                return this->fail();
+            }
+            this->head.clear();
+            this->current_part = {};
+            this->current_state = state::headers;
+            return std::nullopt;
+        }
+        if (this->line.size() > 256) {
+            return this->fail();
+        }
+    }
+    return event{need_more};
+}
+
+// Collects the header block of a part, which ends with an empty line
+std::optional<parser::event> parser::on_headers(std::string_view& input) {
+    if (input.empty()) {
+        return event{need_more};
+    }
+    size_t old_size = this->head.size();
+    this->head.append(input.substr(0, this->limit.max_part_header + 4 - old_size));
+
+    // where the header lines end, and where the empty line after them does
+    size_t lines_end{};
+    size_t block_end{};
+    if (this->head.starts_with(CRLF)) {
+        lines_end = 0;
+        block_end = CRLF.size();
+    } else if (auto pos = this->head.find("\r\n\r\n", old_size < 3 ? 0 : old_size - 3); pos != std::string::npos) {
+        lines_end = pos + CRLF.size();
+        block_end = pos + 2 * CRLF.size();
+    } else {
+        if (this->head.size() > this->limit.max_part_header) {
+            return this->fail();
+        }
+        input.remove_prefix(this->head.size() - old_size);
+        return event{need_more};
+    }
+
+    input.remove_prefix(block_end - old_size);
+    this->head.resize(lines_end);
+    if (!this->parse_part_header()) {
+        return this->fail();
+    }
+    this->current_state = state::data;
+    return event{part};
+}
+
+bool parser::parse_part_header() {
+    auto& part = this->current_part;
+    std::string_view lines = this->head;
+    while (!lines.empty()) {
+        auto end = lines.find(CRLF);
+        if (!request::detail::parse_header_line(lines.substr(0, end), part.header)) {
+            return false;
+        }
+        lines.remove_prefix(end + CRLF.size());
+    }
+
+    // form-data; name="field"; filename="file.txt"
+    auto disposition = part.header["Content-Disposition"];
+    auto rest = disposition.substr(std::min(disposition.find(';'), disposition.size()));
+    while (auto p = next_param(rest)) {
+        if (request::iequals(p->key, "name")) {
+            part.name = p->value;
+        } else if (request::iequals(p->key, "filename")) {
+            part.filename = p->value;
+        }
+    }
+    return true;
+}
+
+parser::event parser::fail() {
+    this->current_state = state::failed;
+    return {failed};
+}
+
+} // namespace http::multipart
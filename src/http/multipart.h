@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "http/request.h"
+
+// multipart/form-data bodies (RFC 7578), parsed as they arrive
+namespace http::multipart {
+
+// The boundary parameter of a multipart Content-Type, nullopt when the type
+// is not multipart or the boundary is missing or malformed
+std::optional<std::string_view> boundary(std::string_view content_type);
+
+using header = request::header;
+
+// Views into the parser, valid until it reaches the next part
+struct part {
+    multipart::header header{};
+    // from Content-Disposition
+    std::string_view name{};
+    std::optional<std::string_view> filename{};
+
+    bool is_file() const {
+        return this->filename.has_value();
+    }
+};
+
+struct limits {
+    // header lines of a single part together
+    size_t max_part_header{8 * 1024};
+};
+
+// Incremental parser over the bytes of a multipart body, fed any split of
+// it. next() turns input into events one at a time, the body of a part
+// comes as data pieces that point into the input, so parts of any size go
+// through without being buffered:
+//
+//     while (true) {
+//         auto [kind, data] = parser.next(input);
+//         if (kind == event::need_more) { input = <next piece of the body>; }
+//         ...
+//     }
+//
+// The only bytes held back are the few at the end of an input that may be
+// the start of a boundary, data pieces then point into the parser until
+// the next call.
+class parser {
+public:
+    struct event {
+        enum class kind_t {
+            // `input` is used up
+            need_more,
+            // the headers of a new part are in current()
+            part,
+            // a piece of the current part's body, in `data`
+            data,
+            part_end,
+            // the closing boundary, anything after it is ignored
+            done,
+            failed,
+        };
+        kind_t           kind;
+        std::string_view data{};
+    };
+    using enum event::kind_t;
+
+    explicit parser(std::string_view boundary, multipart::limits limit = {});
+    parser(const parser&) = delete;
+    parser& operator=(const parser&) = delete;
+
+    // Consumes from the front of `input` up to the next event
+    event next(std::string_view& input);
+
+    const multipart::part& current() const {
+        return this->current_part;
+    }
+
+private:
+    enum class state {
+        preamble,
+        after_boundary,
+        headers,
+        data,
+        done,
+        failed,
+    };
+
+    struct match {
+        size_t pos;
+        // the delimiter is whole at `pos`, rather than cut off by the end
+        bool   full;
+    };
+
+    match find_delimiter(std::string_view input) const;
+    std::optional<event> on_body(std::string_view& input, bool emit);
+    std::optional<event> on_after_boundary(std::string_view& input);
+    std::optional<event> on_headers(std::string_view& input);
+    bool parse_part_header();
+    event fail();
+
+    multipart::limits limit;
+    // CRLF "--" boundary
+    std::string       delimiter;
+    state             current_state{state::preamble};
+    // a prefix of the delimiter the last input ended with
+    std::string       carry{};
+    // carry once it turned out to be data, handed out from here
+    std::string       spill{};
+    std::string       line{};
+    std::string       head{};
+    multipart::part   current_part{};
+};
+
+} // namespace http::multipart
@@ -1,7 +1,14 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <charconv>
 #include <ranges>
+#include <utility>
 
 #include "meta.h"
 #include "http/request.h"
+#include "http/scan.h"
 
 namespace http::request {
 
@@ -9,126 +16,88 @@ namespace {
 constexpr char CR = '\r';
 constexpr char LF = '\n';
 constexpr char SP = ' ';
-constexpr char HTAB = '\t';
 
 constexpr std::string_view CRLF = "\r\n";
+constexpr std::string_view WS = " \t";
 
-constexpr bool is_tchar(char c) {
-    constexpr auto map = 
-        [](){
-            std::array<bool, 256> map{};
-            for (auto& c :"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!#$%&'*+-.^_`|~"){
-                map[static_cast<unsigned char>(c)] = true;
-            }
-            return map;
-        }();
-
-    return map[static_cast<unsigned char>(c)];
-}
-constexpr bool is_pchar_with_out_pct(char c) {
-    constexpr auto map = 
-        [](){
-            std::array<bool, 256> map{};
-            for (auto& c :"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-._~!$&'()*+,;=:@"){
-                map[static_cast<unsigned char>(c)] = true;
-            }
-            return map;
-        }();
-
-    return map[static_cast<unsigned char>(c)];
-}
-
-
-
-
-template <std::forward_iterator It, std::sentinel_for<It> Sent>
-    requires std::same_as<std::iter_value_t<It>, char>
-bool is_query(It first, Sent last) {
-    while (first != last) {
-        if (is_pchar_with_out_pct(*first) || *first == '?' || *first == '/') {
-            ++first;
-        } else if(*first == '%') {
-            ++first;
-            if (first == last) return false;
-            if (!std::isxdigit(static_cast<unsigned char>(*first))) return false;
-
-            ++first;
-            if (first == last) return false; 
-            if (!std::isxdigit(static_cast<unsigned char>(*first))) return false;
+constexpr scan::char_set tchar{
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!#$%&'*+-.^_`|~"
+};
+// pchar without pct-encoded, plus '/' for paths and '/' and '?' for queries
+constexpr scan::char_set path_char{
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-._~!$&'()*+,;=:@/"
+};
+constexpr scan::char_set query_char{
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-._~!$&'()*+,;=:@/?"
+};
 
-            ++first; 
-        } else {
+// Whether `str` is made of bytes in `set` and well formed %XX escapes
+bool is_pct_encoded(std::string_view str, const scan::char_set& set) {
+    while (true) {
+        str.remove_prefix(scan::span(str, set));
+        if (str.empty()) {
+            return true;
+        }
+        if (str.size() < 3 || str[0] != '%'
+            || !std::isxdigit(static_cast<unsigned char>(str[1]))
+            || !std::isxdigit(static_cast<unsigned char>(str[2]))) {
             return false;
         }
+        str.remove_prefix(3);
     }
-    return true;
 }
 
-template <std::ranges::forward_range R>
-    requires std::same_as<std::ranges::range_value_t<R>, char>
-bool is_query(R&& range) {
-    return is_query(std::ranges::begin(range), std::ranges::end(range));
+bool is_query(std::string_view str) {
+    return is_pct_encoded(str, query_char);
 }
 
+bool is_absolut_path(std::string_view str) {
+    return is_pct_encoded(str, path_char);
+}
 
-template <std::forward_iterator It, std::sentinel_for<It> Sent>
-    requires std::same_as<std::iter_value_t<It>, char>
-bool is_absolut_path(It first, Sent last) {
-    while (first != last) {
-        if (is_pchar_with_out_pct(*first) || *first == '/') {
-            ++first;
-        } else if(*first == '%') {
-            ++first;
-            if (first == last) return false;
-            if (!std::isxdigit(static_cast<unsigned char>(*first))) return false;
-
-            ++first;
-            if (first == last) return false; 
-            if (!std::isxdigit(static_cast<unsigned char>(*first))) return false;
-
-            ++first; 
-        } else {
-            return false;
+// method SP request-target SP HTTP-version
+std::optional<std::array<std::string_view, 3>> split_request_line(std::string_view line) {
+    std::array<std::string_view, 3> parts{};
+    for (size_t i = 0; i < 2; ++i) {
+        auto pos = scan::find_byte(line, SP);
+        if (pos == std::string_view::npos) {
+            return std::nullopt;
         }
+        parts[i] = line.substr(0, pos);
+        line.remove_prefix(pos + 1);
     }
-    return true;
-}
-
-template <std::ranges::forward_range R>
-    requires std::same_as<std::ranges::range_value_t<R>, char>
-bool is_absolut_path(R&& range) {
-    return is_absolut_path(std::ranges::begin(range), std::ranges::end(range));
+    if (scan::find_byte(line, SP) != std::string_view::npos) {
+        return std::nullopt;
+    }
+    parts[2] = line;
+    return parts;
 }
 
-
-
 constexpr std::string_view trim(std::string_view in) {
-    auto is_space = [](char c){ 
-        return c == SP || c == HTAB; 
-    };
+    auto first = in.find_first_not_of(WS);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return in.substr(first, in.find_last_not_of(WS) - first + 1);
+}
 
-    auto view = in
-        | std::views::drop_while(is_space)
-        | std::views::reverse
-        | std::views::drop_while(is_space)
-        | std::views::reverse;
+// Transfer-Encoding lists the codings in the order they were applied, a
+// request body has to end with chunked to be framed at all
+constexpr bool is_chunked(std::string_view codings) {
+    auto pos = codings.rfind(',');
+    return iequals(trim(pos == std::string_view::npos ? codings : codings.substr(pos + 1)), "chunked");
+}
 
-    return {view.begin().base().base(), view.end().base().base()};
+// Next field after `it` with the same name. The slot table only points at
+// the first occurrence, repeats are rare and looked up by name.
+const field* next_occurrence(const header& header, const field* it) {
+    auto name = it->name;
+    while (++it != header.end() && !iequals(it->name, name)) {}
+    return it;
 }
 
 };
 
-template <typename lambda_t>
-    requires std::is_same_v<bool, std::invoke_result_t<lambda_t, char>>
-std::string_view parse_token(std::string_view str, lambda_t&& is_valid) {
-    for (auto [i, c] : std::views::enumerate(str)){
-        if (!is_valid(c)) {
-            return str.substr(0, i);
-        }
-    }
-    return str;
-}
-
 std::optional<target> parse_target(std::string_view str){
     if (str.starts_with("/")){
         // origin form
@@ -148,7 +117,7 @@ std::optional<target> parse_target(std::string_view str){
             return std::nullopt;
         }
 
-        return origin_form{std::string(path), std::string(query)};
+        return origin_form{path, query};
     }
 
     else if (str == "*") {
@@ -159,138 +128,454 @@ std::optional<target> parse_target(std::string_view str){
     return absolute_form{};
 }
 
-std::optional<std::string_view> parser::get_line() {
-    if (auto line_end = this->data_view.find(CRLF); line_end != std::string_view::npos){
-        auto line_view = this->data_view.substr(0, line_end);
-        this->data_view.remove_prefix(line_end + CRLF.size());
-        if (!this->line_buffer.empty()){
-            this->line_buffer.append(line_view);
-            line_view = this->line_buffer;
-            this->line_buffer.clear();
-        }
-        return line_view;
-    } else {
-        this->line_buffer.append(this->data_view);
-        this->data_view = std::string_view{};
-        return std::nullopt;
+namespace detail {
+
+bool parse_request_line(std::string_view line, request::line& out) {
+    auto parts = split_request_line(line);
+    if (!parts) {
+        return false;
+    }
+    auto method_opt = meta::enum_from_string<method>((*parts)[0]);
+    if (!method_opt) {
+        return false;
     }
+    auto target_opt = parse_target((*parts)[1]);
+    if (!target_opt) {
+        return false;
+    }
+    out = {*method_opt, *target_opt, (*parts)[2]};
+    return true;
 }
 
-parser::parse_task parser::task(parser* p) {
-    using wait_message = parser::parse_task::wait_message;
+template<size_t N>
+bool parse_header_line(std::string_view line, basic_header<N>& out) {
+    auto key = line.substr(0, scan::span(line, tchar));
+    line.remove_prefix(key.size());
+    if (key.empty() || line.empty() || line.front() != ':') {
+        return false;
+    }
+    line.remove_prefix(1); // Skip ':'
+    out.emplace(key, trim(line));
+    return true;
+}
 
-    auto instance = p;
+template bool parse_header_line(std::string_view, header&);
+template bool parse_header_line(std::string_view, trailer&);
 
-    instance->data_view = co_await wait_message{};
+} // namespace detail
 
-    while (true) {
-        start_over:
-        
-        request::msg request{};
-    
-        // Parse request line
-        std::optional<std::string_view> line_opt{};
-
-        while (!(line_opt = instance->get_line())) {
-            instance->data_view = co_await wait_message{};
+size_t parser::feed(std::string_view data) {
+    const size_t size = data.size();
+    while (!data.empty() && !this->streaming) {
+        if (this->current_state == state::body) {
+            this->consume_body(data);
+            continue;
+        }
+        if (this->current_state == state::chunk_data) {
+            this->consume_chunk(data);
+            continue;
+        }
+        auto line = this->get_line(data);
+        if (!line) {
+            if (this->line_buffer.size() <= this->max_line_length()) {
+                break;
+            }
+            this->reject(this->line_too_long());
         }
-        auto line_parts = line_opt.value()
-            | std::views::split(SP)
-            | std::views::transform([](auto&& rng) {
-                return std::string_view(rng);
-            })
-            | std::ranges::to<std::vector<std::string_view>>();
-
-        if (line_parts.size() != 3) {
-            instance->fail_parse();
-            goto start_over;
+        if (!line || !this->on_line(*line)) {
+            // the rest of the stream cannot be trusted to start a request
+            this->fail();
+            return size;
         }
+    }
+    if (this->current_state != state::request_line && !this->streaming) {
+        this->pin();
+    }
+    return size - data.size();
+}
 
-        auto method_opt = 
-            meta::enum_from_string<method>(line_parts[0]);
-        if (!method_opt) {
-            instance->fail_parse();
-            goto start_over;
+std::string_view parser::read_body(std::string_view& data) {
+    while (this->streaming && !data.empty()) {
+        if (this->current_state == state::body) {
+            auto piece = data.substr(0, this->body_length - this->body_received);
+            this->body_received += piece.size();
+            data.remove_prefix(piece.size());
+            if (this->body_received == this->body_length) {
+                this->end_stream();
+            }
+            return piece;
+        }
+        if (this->current_state == state::chunk_data) {
+            auto piece = data.substr(0, this->chunk_remaining);
+            this->chunk_remaining -= piece.size();
+            this->body_received += piece.size();
+            data.remove_prefix(piece.size());
+            if (this->chunk_remaining == 0) {
+                this->current_state = state::chunk_data_end;
+            }
+            return piece;
+        }
+        // chunk framing and trailers, nothing of it is handed out
+        auto line = this->get_line(data);
+        if (!line) {
+            if (this->line_buffer.size() <= this->max_line_length()) {
+                break;
+            }
+            this->reject(this->line_too_long());
+        }
+        if (!line || !this->on_line(*line)) {
+            this->fail();
+            break;
         }
+        this->line_buffer.clear();
+    }
+    return {};
+}
 
-        auto target_opt = 
-            parse_target(line_parts[1]);
-        if (!target_opt) {
-            instance->fail_parse();
-            goto start_over;
+void parser::reset() {
+    this->current_state = state::request_line;
+    this->rejection = request::error::malformed;
+    this->streaming = false;
+    this->stream_failed = false;
+    this->current.clear();
+    this->stream_end.clear();
+    this->pinned = {};
+    this->line_buffer.clear();
+    this->body_buffer = nullptr;
+    this->chunk_body.clear();
+    this->ready.clear();
+    this->ready_head = 0;
+}
+
+std::optional<std::string_view> parser::get_line(std::string_view& data) {
+    // CR at the end of the previous buffer, LF at the start of this one
+    if (this->line_buffer.ends_with(CR) && data.starts_with(LF)) {
+        data.remove_prefix(1);
+        return this->buffered_line(std::string_view{this->line_buffer}.substr(0, this->line_buffer.size() - 1));
+    }
+    if (auto line_end = scan::find_crlf(data); line_end != std::string_view::npos){
+        auto line_view = data.substr(0, line_end);
+        data.remove_prefix(line_end + CRLF.size());
+        if (!this->line_buffer.empty()){
+            // the line spans two buffers, the only case it gets copied
+            this->line_buffer.append(line_view);
+            line_view = this->buffered_line(this->line_buffer);
         }
+        return line_view;
+    } else {
+        this->line_buffer.append(data);
+        data = std::string_view{};
+        return std::nullopt;
+    }
+}
 
-        request.line = {
-            *method_opt,
-            std::move(target_opt.value()),
-            std::string(line_parts[2])
-        };
+// A line put together in line_buffer goes into the storage of its message,
+// except for the framing of a streamed body: nothing of it outlives
+// on_line(), and keeping it would grow the storage with the upload, so it
+// is parsed in place and read_body() clears line_buffer after it
+std::string_view parser::buffered_line(std::string_view line) {
+    if (this->streaming) {
+        return line;
+    }
+    line = this->current.keep(line);
+    this->line_buffer.clear();
+    return line;
+}
+
+size_t parser::max_line_length() const {
+    switch (this->current_state) {
+        case state::request_line:
+            return this->limit.max_request_line;
+        case state::header_line:
+            return this->limit.max_header_size - this->header_bytes;
+        case state::chunk_size:
+        case state::chunk_data_end:
+            return this->limit.max_chunk_line;
+        case state::trailer_line:
+            return this->limit.max_trailer_size - this->trailer_bytes;
+        default:
+            return SIZE_MAX;
+    }
+}
 
+size_t parser::max_body_size() const {
+    return this->mode == body_mode::stream ? this->limit.max_streamed_body : this->limit.max_body_size;
+}
 
+request::error parser::line_too_long() const {
+    switch (this->current_state) {
+        case state::request_line:
+            return request::error::request_line_too_long;
+        case state::header_line:
+        case state::trailer_line:
+            return request::error::header_too_large;
+        default:
+            return request::error::malformed;
+    }
+}
 
-        // Parse headers
-        while (!instance->data_view.starts_with(CRLF)) {
-            std::optional<std::string_view> line_opt;
-            while (!(line_opt = instance->get_line())) {
-                instance->data_view = co_await wait_message{};
+bool parser::on_line(std::string_view line) {
+    if (line.size() > this->max_line_length()) {
+        return this->reject(this->line_too_long());
+    }
+    switch (this->current_state) {
+        case state::request_line:
+            this->current_state = state::header_line;
+            this->header_bytes = 0;
+            return detail::parse_request_line(line, this->current.line);
+        case state::header_line:
+            if (line.empty()) {
+                return this->on_header_end();
             }
-            auto line_view = line_opt.value();
-
-            auto key = parse_token(line_view, is_tchar);
-            line_view.remove_prefix(key.size());
-            if (key.empty()) {
-                instance->fail_parse();
-                goto start_over;
+            if (this->current.header.size() == this->limit.max_header_count) {
+                return this->reject(request::error::header_too_large);
             }
-            if (line_view.empty() || line_view.front() != ':') {
-                instance->fail_parse();
-                goto start_over;
+            this->header_bytes += line.size();
+            return detail::parse_header_line(line, this->current.header);
+        case state::chunk_size:
+            return this->on_chunk_size(line);
+        case state::chunk_data_end:
+            // chunk data is followed by a bare CRLF
+            this->current_state = state::chunk_size;
+            return line.empty();
+        case state::trailer_line:
+            if (line.empty()) {
+                if (this->streaming) {
+                    this->end_stream();
+                } else {
+                    this->finish_chunked();
+                }
+                return true;
             }
-            line_view.remove_prefix(1); // Skip ':'
+            this->trailer_bytes += line.size();
+            if (this->streaming) {
+                // outlives read_body() in trailers(), and is bounded by
+                // max_trailer_size unlike the chunk framing
+                line = this->current.keep(line);
+            }
+            return detail::parse_header_line(line, this->current.trailer);
+        default:
+            return false;
+    }
+}
 
-            request.header.emplace(trim(key), trim(line_view));
+bool parser::on_header_end() {
+    auto& header = this->current.header;
+    auto content_length_it = header.find(known_field::content_length);
 
+    if (auto transfer_encoding_it = header.find(known_field::transfer_encoding); transfer_encoding_it != header.end()) {
+        // both framings at once is how requests get smuggled past proxies
+        if (content_length_it != header.end()) {
+            return false;
+        }
+        // repeated fields add up to one list, so the last one decides
+        for (auto it = transfer_encoding_it; it != header.end(); it = next_occurrence(header, it)) {
+            transfer_encoding_it = it;
+        }
+        if (!is_chunked(transfer_encoding_it->value)) {
+            return false;
+        }
+        this->chunk_body.clear();
+        this->body_received = 0;
+        this->current_state = state::chunk_size;
+        if (this->mode == body_mode::stream) {
+            this->start_stream();
+        }
+        return true;
+    }
 
-            if (instance->data_view.empty()) {
-                instance->data_view = co_await wait_message{};
-            }
+    if (content_length_it == header.end()) {
+        this->complete();
+        return true;
+    }
+    // copies of the same length are harmless, differing ones are ambiguous
+    for (auto it = next_occurrence(header, content_length_it); it != header.end(); it = next_occurrence(header, it)) {
+        if (it->value != content_length_it->value) {
+            return false;
         }
-        instance->data_view.remove_prefix(CRLF.size());
+    }
+    auto str = content_length_it->value;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), this->body_length);
+    if (ec != std::errc{} || ptr != str.data() + str.size()) {
+        return false;   // Invalid Content-Length
+    }
+    if (this->body_length > this->max_body_size()) {
+        return this->reject(request::error::body_too_large);
+    }
+    if (this->body_length == 0) {
+        this->complete();
+        return true;
+    }
+    this->body_received = 0;
+    this->body_buffer = nullptr;
+    this->current_state = state::body;
+    if (this->mode == body_mode::stream) {
+        this->start_stream();
+    }
+    return true;
+}
 
-        // Parse body if Content-Length is present
-        if(auto content_length_it = request.header.find("Content-Length"); content_length_it != request.header.end()) {
-            size_t content_length{};
+// chunk-size [ chunk-ext ], the extensions are skipped
+bool parser::on_chunk_size(std::string_view line) {
+    size_t size{};
+    auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+    if (ec != std::errc{}) {
+        return false;   // no hex digits, or too many
+    }
+    if (auto ext = trim({ptr, line.data() + line.size()}); !ext.empty() && ext.front() != ';') {
+        return false;
+    }
+    if (size == 0) {
+        this->trailer_bytes = 0;
+        this->current_state = state::trailer_line;
+        return true;
+    }
+    auto received = this->streaming ? this->body_received : this->chunk_body.size();
+    if (size > this->max_body_size() - received) {
+        return this->reject(request::error::body_too_large);
+    }
+    this->chunk_remaining = size;
+    this->current_state = state::chunk_data;
+    return true;
+}
 
-            auto str = content_length_it->second;
+void parser::consume_body(std::string_view& data) {
+    if (this->body_buffer == nullptr && data.size() >= this->body_length) {
+        // all of it arrived with the headers
+        this->current.body = data.substr(0, this->body_length);
+        data.remove_prefix(this->body_length);
+        this->complete();
+        return;
+    }
+    if (this->body_buffer == nullptr) {
+        this->body_buffer = this->current.allocate(this->body_length);
+    }
+    auto chunk = data.substr(0, this->body_length - this->body_received);
+    chunk.copy(this->body_buffer + this->body_received, chunk.size());
+    this->body_received += chunk.size();
+    data.remove_prefix(chunk.size());
+    if (this->body_received == this->body_length) {
+        this->current.body = {this->body_buffer, this->body_length};
+        this->body_buffer = nullptr;
+        this->complete();
+    }
+}
 
-            auto [ptr, ec] = std::from_chars(
-                str.data(), 
-                str.data() + str.size(),
-                content_length
-            );
+void parser::consume_chunk(std::string_view& data) {
+    auto chunk = data.substr(0, this->chunk_remaining);
+    this->chunk_body.append(chunk);
+    this->chunk_remaining -= chunk.size();
+    data.remove_prefix(chunk.size());
+    if (this->chunk_remaining == 0) {
+        this->current_state = state::chunk_data_end;
+    }
+}
 
-            if (ec != std::errc{}) {
-                instance->fail_parse();
-                goto start_over;  // Invalid Content-Length
-            }
+void parser::finish_chunked() {
+    if (!this->chunk_body.empty()) {
+        this->current.body = this->current.keep(this->chunk_body);
+    }
+    this->chunk_body.clear();
+    // keep a buffer for the usual small bodies, not for the odd large one
+    if (this->chunk_body.capacity() > 64 * 1024) {
+        this->chunk_body = std::string{};
+    }
+    this->complete();
+}
 
-            while (request.body.size() < content_length) {
-                auto need_to_read = content_length - request.body.size();
-                if (need_to_read > instance->data_view.size()) {
-                    request.body.append(instance->data_view);
-                    instance->data_view = co_await wait_message{};
-                } else {
-                    request.body.append(instance->data_view.substr(0, need_to_read));
-                    instance->data_view.remove_prefix(need_to_read);
-                }
-            }
+// Hands out the message ahead of its body, `current` is kept as scratch
+// for the chunk framing until end_stream()
+void parser::start_stream() {
+    this->current.body_follows = true;
+    this->ready.emplace_back(std::move(this->current));
+    this->current.clear();
+    this->pinned = {};
+    this->stream_end.clear();
+    this->streaming = true;
+    this->stream_failed = false;
+}
+
+// The trailers were kept while streaming, so they stay valid along with
+// the storage that moves with them
+void parser::end_stream() {
+    this->stream_end = std::move(this->current);
+    this->current.clear();
+    this->streaming = false;
+    this->current_state = state::request_line;
+}
+
+// Moves what has been parsed of `current` so far into its own storage,
+// called when feed() returns since the caller reuses its buffer
+void parser::pin() {
+    auto& request = this->current;
+    auto* origin = std::get_if<origin_form>(&request.line.target);
+    auto fields = std::span{request.header.begin() + this->pinned.headers, request.header.end()};
+    auto trailers = std::span{request.trailer.begin() + this->pinned.trailers, request.trailer.end()};
+
+    size_t bytes = 0;
+    if (!this->pinned.line) {
+        bytes += request.line.version.size();
+        if (origin) {
+            bytes += origin->path.size() + origin->query.size();
         }
+    }
+    for (const auto& [name, value] : fields) {
+        bytes += name.size() + value.size();
+    }
+    for (const auto& [name, value] : trailers) {
+        bytes += name.size() + value.size();
+    }
 
-        instance->msg_queue.push(std::move(request));
+    if (bytes != 0) {
+        char* out = request.allocate(bytes);
+        auto move = [&out](std::string_view& str) {
+            str.copy(out, str.size());
+            str = {out, str.size()};
+            out += str.size();
+        };
+        if (!this->pinned.line) {
+            move(request.line.version);
+            if (origin) {
+                move(origin->path);
+                move(origin->query);
+            }
+        }
+        for (auto& [name, value] : fields) {
+            move(name);
+            move(value);
+        }
+        for (auto& [name, value] : trailers) {
+            move(name);
+            move(value);
+        }
     }
+    this->pinned.line = true;
+    this->pinned.headers = request.header.size();
+    this->pinned.trailers = request.trailer.size();
 }
 
+void parser::complete() {
+    this->ready.emplace_back(std::move(this->current));
+    this->current.clear();
+    this->pinned = {};
+    this->current_state = state::request_line;
+}
 
+bool parser::reject(request::error reason) {
+    this->rejection = reason;
+    return false;
+}
 
+void parser::fail() {
+    if (this->streaming) {
+        this->streaming = false;
+        this->stream_failed = true;
+    }
+    this->ready.emplace_back(std::unexpect, std::exchange(this->rejection, request::error::malformed));
+    this->current.clear();
+    this->pinned = {};
+    this->line_buffer.clear();
+    this->current_state = state::request_line;
+}
 
 } // namespace http::request
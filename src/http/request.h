@@ -1,12 +1,21 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <forward_list>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <optional>
-#include <queue>
+#include <span>
 #include <string_view>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <variant>
-#include "coro/sendable_task.h"
+#include <vector>
 #include "meta.h"
 
 
@@ -23,10 +32,192 @@ enum class method {
     TRACE
 };
 
-using header = std::unordered_map<std::string, std::string>;
-using path = std::string;
-using query = std::string;
-using body = std::string;
+// Everything below is a view, either into the buffer handed to
+// parser::feed() or into the storage of the msg it belongs to.
+using path = std::string_view;
+using query = std::string_view;
+using body = std::string_view;
+
+struct field {
+    std::string_view name;
+    std::string_view value;
+};
+
+constexpr char to_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// ASCII case-insensitive, which is what field names and most tokens are
+constexpr bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::ranges::equal(a, b, {}, to_lower, to_lower);
+}
+
+// Fields the parser looks at or handlers commonly ask for. They are
+// recognized once while parsing, looking them up afterwards is an index.
+enum class known_field {
+    host,
+    connection,
+    content_length,
+    content_type,
+    transfer_encoding,
+    accept,
+    accept_encoding,
+    cookie,
+    expect,
+    if_modified_since,
+    if_none_match,
+    range,
+    upgrade,
+    user_agent,
+};
+
+constexpr std::array known_field_names{
+    std::string_view{"Host"},
+    std::string_view{"Connection"},
+    std::string_view{"Content-Length"},
+    std::string_view{"Content-Type"},
+    std::string_view{"Transfer-Encoding"},
+    std::string_view{"Accept"},
+    std::string_view{"Accept-Encoding"},
+    std::string_view{"Cookie"},
+    std::string_view{"Expect"},
+    std::string_view{"If-Modified-Since"},
+    std::string_view{"If-None-Match"},
+    std::string_view{"Range"},
+    std::string_view{"Upgrade"},
+    std::string_view{"User-Agent"},
+};
+static_assert(known_field_names.size() == meta::count_enum_values<known_field>());
+
+// Dispatches on the length first, so an unknown name costs a switch and
+// rarely more than one comparison
+constexpr std::optional<known_field> to_known_field(std::string_view name) {
+    auto match = [name](std::initializer_list<known_field> candidates) -> std::optional<known_field> {
+        for (auto id : candidates) {
+            if (iequals(known_field_names[static_cast<size_t>(id)], name)) {
+                return id;
+            }
+        }
+        return std::nullopt;
+    };
+    using enum known_field;
+    switch (name.size()) {
+        case 4:  return match({host});
+        case 5:  return match({range});
+        case 6:  return match({accept, cookie, expect});
+        case 7:  return match({upgrade});
+        case 10: return match({connection, user_agent});
+        case 12: return match({content_type});
+        case 13: return match({if_none_match});
+        case 14: return match({content_length});
+        case 15: return match({accept_encoding});
+        case 17: return match({transfer_encoding, if_modified_since});
+        default: return std::nullopt;
+    }
+}
+static_assert([] {
+    for (size_t i = 0; i < known_field_names.size(); ++i) {
+        if (to_known_field(known_field_names[i]) != static_cast<known_field>(i)) {
+            return false;
+        }
+    }
+    return true;
+}(), "every known field has to be reachable from the switch above");
+
+// Header fields in arrival order. The first `inline_capacity` fields live
+// inside the object, only requests with more of them spill to the heap.
+// Names compare case-insensitively. Known fields are found through a slot
+// table filled by emplace(), the others by a linear search, which beats
+// hashing for the dozen or so fields a request carries.
+template<size_t N>
+class basic_header {
+public:
+    static constexpr size_t inline_capacity = N;
+
+    void emplace(std::string_view name, std::string_view value) {
+        if (this->count < inline_capacity) {
+            this->inline_fields[this->count] = {name, value};
+        } else {
+            if (this->overflow.empty()) {
+                this->overflow.assign(this->inline_fields.begin(), this->inline_fields.end());
+            }
+            this->overflow.push_back({name, value});
+        }
+        // a repeated field is found by its first occurrence, as by name
+        if (auto id = to_known_field(name); id && this->slots[static_cast<size_t>(*id)] == 0) {
+            this->slots[static_cast<size_t>(*id)] = static_cast<uint32_t>(this->count + 1);
+        }
+        ++this->count;
+    }
+
+    const field* find(known_field id) const {
+        auto slot = this->slots[static_cast<size_t>(id)];
+        return slot == 0 ? this->end() : this->begin() + (slot - 1);
+    }
+
+    const field* find(std::string_view name) const {
+        if (auto id = to_known_field(name); id) {
+            return this->find(*id);
+        }
+        for (const auto& f : *this) {
+            if (iequals(f.name, name)) {
+                return &f;
+            }
+        }
+        return this->end();
+    }
+
+    bool contains(known_field id) const {
+        return this->slots[static_cast<size_t>(id)] != 0;
+    }
+
+    bool contains(std::string_view name) const {
+        return this->find(name) != this->end();
+    }
+
+    // Value of the first field called `name`, empty if there is none
+    std::string_view operator[](std::string_view name) const {
+        auto it = this->find(name);
+        return it == this->end() ? std::string_view{} : it->value;
+    }
+
+    std::string_view operator[](known_field id) const {
+        auto it = this->find(id);
+        return it == this->end() ? std::string_view{} : it->value;
+    }
+
+    size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+
+    void clear() {
+        this->count = 0;
+        this->overflow.clear();
+        this->slots = {};
+    }
+
+    field* begin() { return this->data(); }
+    field* end() { return this->data() + this->count; }
+    const field* begin() const { return this->data(); }
+    const field* end() const { return this->data() + this->count; }
+
+private:
+    field* data() {
+        return this->overflow.empty() ? this->inline_fields.data() : this->overflow.data();
+    }
+    const field* data() const {
+        return this->overflow.empty() ? this->inline_fields.data() : this->overflow.data();
+    }
+
+    std::array<field, inline_capacity> inline_fields{};
+    std::vector<field>                 overflow{};
+    size_t                             count{0};
+    // index + 1 of the first field of each known kind, 0 if absent
+    std::array<uint32_t, known_field_names.size()> slots{};
+};
+
+using header = basic_header<24>;
+// fields after a chunked body, rare and few, kept apart from the header
+using trailer = basic_header<4>;
 
 struct origin_form{
     request::path  path;
@@ -52,17 +243,34 @@ struct line{
             version
         );
     }
-    request::method method;
-    request::target target;
-    std::string     version;
+    request::method  method;
+    request::target  target;
+    std::string_view version;
 };
 
+// Only moved, never copied: the views may point into `storage`.
 struct msg{    
     void clear() {
         line = {};
         header.clear();
-        body.clear();
+        body = {};
+        body_follows = false;
+        trailer.clear();
+        storage.clear();
+    }
+
+    // Memory that lives as long as the message, for the bytes that did not
+    // arrive within a single buffer
+    char* allocate(size_t size) {
+        return this->storage.emplace_front(std::make_unique_for_overwrite<char[]>(size)).get();
     }
+
+    std::string_view keep(std::string_view str) {
+        char* data = this->allocate(str.size());
+        str.copy(data, str.size());
+        return {data, str.size()};
+    }
+
     template<typename out_t>
     auto format_to(out_t&& out) const {
         auto it = line.format_to(std::forward<out_t>(out));
@@ -72,51 +280,205 @@ struct msg{
         it = std::format_to(it, "\r\n{}", body);
         return it;
     }
-    request::line   line{};
-    request::header header{};
-    request::body   body{};
+    request::line    line{};
+    request::header  header{};
+    request::body    body{};
+    request::trailer trailer{};
+    // the body was left to parser::read_body() rather than put into `body`
+    bool             body_follows{false};
+    std::forward_list<std::unique_ptr<char[]>> storage{};
+};
+
+// How a parser hands out request bodies
+enum class body_mode {
+    // into msg::body, the message is ready once its body is complete
+    buffer,
+    // the message is ready after its headers and the body is pulled
+    // through parser::read_body()
+    stream,
+};
+
+// Bounds on what a single request may make the parser hold or wait for,
+// checked as soon as the bytes arrive rather than once the request is whole
+struct limits {
+    // request line, the target included
+    size_t max_request_line{8 * 1024};
+    // header lines together, and how many of them there may be
+    size_t max_header_size{32 * 1024};
+    size_t max_header_count{100};
+    // decoded body, whether sized by Content-Length or chunked, when it is
+    // buffered
+    size_t max_body_size{16 * 1024 * 1024};
+    // the same for a streamed body, which takes no memory however long it
+    // is, so there is no limit by default
+    size_t max_streamed_body{SIZE_MAX};
+    // chunk size line, extensions included
+    size_t max_chunk_line{4096};
+    // all trailer lines of a chunked body together
+    size_t max_trailer_size{8 * 1024};
+};
+
+// Why a request failed to parse
+enum class error {
+    malformed,
+    request_line_too_long,
+    // over max_header_size, max_header_count or max_trailer_size
+    header_too_large,
+    body_too_large,
 };
 
+namespace detail {
+
+// Single line parsers shared by the request parser, the views they store
+// point into `line`
+bool parse_request_line(std::string_view line, request::line& out);
+template<size_t N>
+bool parse_header_line(std::string_view line, basic_header<N>& out);
+
+} // namespace detail
+
+// Incremental HTTP/1.1 request parser, a state machine over lines that
+// can be fed any split of the stream, down to single bytes. Bodies come
+// either sized by Content-Length or chunked. Exceeding `limits` fails the
+// request as soon as it shows, so a line without an end holds at most a
+// limit's worth of memory.
+//
+// The messages point into the data passed to feed(), which therefore has
+// to stay alive until the messages parsed from it are dealt with. A message
+// that is still incomplete when feed() returns copies what it has so far
+// into its own storage, so the caller may reuse its buffer for the next
+// read.
+//
+// In stream mode feed() stops after the headers of a request that has a
+// body and marks the message body_follows. Until reading_body() turns
+// false the caller then pulls the body through read_body(), whose pieces
+// point into the data they came from, and feeds what is left after it.
+// The trailers of a streamed chunked body are then found in trailers().
+//
+// A parser is meant to live as long as its connection, reset() makes it
+// start over while keeping the memory it has grown so far.
 class parser {
 public:
-    using parse_task = coro::sendable_task<void, std::string_view>;
-    parser() = default;
+    explicit parser(request::limits limit = {}, body_mode mode = body_mode::buffer)
+        : limit(limit), mode(mode) {}
     parser(const parser&) = delete;
     parser(parser&&) = delete;
     parser& operator=(const parser&) = delete;
     parser& operator=(parser&&) = delete;
     ~parser() = default;
 
-    void feed(std::string_view data) {
-        this->t.send_and_resume(data);
+    // Returns how much of `data` was consumed, all of it unless a streamed
+    // body starts within it
+    size_t feed(std::string_view data);
+
+    // Next piece of the streamed body out of `data`, consumed from its
+    // front. Empty once `data` is used up or the body is over.
+    std::string_view read_body(std::string_view& data);
+
+    bool reading_body() const {
+        return this->streaming;
+    }
+
+    // The last streamed body was malformed, the connection is beyond repair
+    bool body_failed() const {
+        return this->stream_failed;
+    }
+
+    // Trailers of the last streamed body once reading_body() turned false,
+    // valid until the next streamed body starts
+    const request::trailer& trailers() const {
+        return this->stream_end.trailer;
+    }
+
+    void reset();
+
+    // Blocks of memory held for the request being parsed, meant for tests
+    size_t held_blocks() const {
+        return std::distance(this->current.storage.begin(), this->current.storage.end());
     }
 
     bool empty() const {
-        return this->msg_queue.empty();
+        return this->ready_head == this->ready.size();
+    }
+
+    // Whether a request has started arriving but its head is not complete
+    bool reading_head() const {
+        return this->current_state == state::header_line
+            || (this->current_state == state::request_line && !this->line_buffer.empty());
     }
 
-    std::optional<msg> pop_front(){
-        auto ret = std::move(this->msg_queue.front());
-        this->msg_queue.pop();
+    // Once a request failed, the rest of the stream cannot be trusted to
+    // start another one
+    std::expected<msg, request::error> pop_front(){
+        auto ret = std::move(this->ready[this->ready_head++]);
+        if (this->empty()) {
+            this->ready.clear();
+            this->ready_head = 0;
+        }
         return ret;
     };
-    
 
 private:
-    void fail_parse() {
-        this->msg_queue.push(std::nullopt);
-        this->line_buffer.clear();
-        this->data_view = std::string_view{};
-    }
-    std::optional<std::string_view> get_line();
+    enum class state {
+        request_line,
+        header_line,
+        body,
+        chunk_size,
+        chunk_data,
+        chunk_data_end,
+        trailer_line,
+    };
 
+    // What of `current` has been moved into its own storage already
+    struct pinned_t {
+        bool   line{false};
+        size_t headers{0};
+        size_t trailers{0};
+    };
 
-    static parse_task task(parser*);
+    std::optional<std::string_view> get_line(std::string_view& data);
+    std::string_view buffered_line(std::string_view line);
+    size_t max_line_length() const;
+    size_t max_body_size() const;
+    request::error line_too_long() const;
+    bool on_line(std::string_view line);
+    bool on_header_end();
+    bool on_chunk_size(std::string_view line);
+    void consume_body(std::string_view& data);
+    void consume_chunk(std::string_view& data);
+    void finish_chunked();
+    void start_stream();
+    void end_stream();
+    void pin();
+    void complete();
+    bool reject(request::error reason);
+    void fail();
 
-    std::string                    line_buffer{};
-    std::string_view               data_view{};
-    parse_task                     t{this->task(this)};
-    std::queue<std::optional<msg>> msg_queue{};
+    request::limits                 limit;
+    body_mode                       mode;
+    state                           current_state{state::request_line};
+    // a body is being streamed, `current` only holds its framing
+    bool                            streaming{false};
+    bool                            stream_failed{false};
+    msg                             current{};
+    // what is left of `current` after a streamed body, its trailers
+    msg                             stream_end{};
+    pinned_t                        pinned{};
+    std::string                     line_buffer{};
+    size_t                          header_bytes{0};
+    // what fail() reports, unless a more precise reason was given
+    request::error                  rejection{request::error::malformed};
+    // body that does not arrive with the headers is collected here
+    char*                           body_buffer{nullptr};
+    size_t                          body_received{0};
+    size_t                          body_length{0};
+    // decoded chunked body, and what is left of the current chunk
+    std::string                     chunk_body{};
+    size_t                          chunk_remaining{0};
+    size_t                          trailer_bytes{0};
+    // parsed messages, ready[ready_head..] are still to be popped
+    std::vector<std::expected<msg, request::error>> ready{};
+    size_t                                          ready_head{0};
 };
 
 } // namespace http::request
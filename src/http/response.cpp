@@ -29,6 +29,10 @@ std::string_view status_code_to_string(status_code code){
             {status_code::forbidden, "Forbidden"},
             {status_code::not_found, "Not Found"},
             {status_code::method_not_allowed, "Method Not Allowed"},
+            {status_code::request_timeout, "Request Timeout"},
+            {status_code::content_too_large, "Content Too Large"},
+            {status_code::uri_too_long, "URI Too Long"},
+            {status_code::request_header_fields_too_large, "Request Header Fields Too Large"},
 
 
             {status_code::internal_server_error, "Internal Server Error"},
@@ -16,6 +16,10 @@ enum class status_code : size_t {
     forbidden =                 403,
     not_found =                 404,
     method_not_allowed =        405,
+    request_timeout =           408,
+    content_too_large =         413,
+    uri_too_long =              414,
+    request_header_fields_too_large = 431,
 
     internal_server_error =     500,
     not_implemented =           501,
@@ -0,0 +1,173 @@
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "http/scan.h"
+
+namespace http::scan {
+
+namespace {
+
+namespace scalar {
+
+const char* find_byte(const char* first, const char* last, char c) {
+    auto it = static_cast<const char*>(std::memchr(first, c, static_cast<size_t>(last - first)));
+    return it ? it : last;
+}
+
+const char* skip(const char* first, const char* last, const char_set& set) {
+    while (first != last && set.contains(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+constexpr kernels table{find_byte, skip};
+
+} // namespace scalar
+
+#if defined(__x86_64__)
+
+namespace sse42 {
+
+__attribute__((target("sse4.2")))
+const char* find_byte(const char* first, const char* last, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    while (last - first >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        if (int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)); mask != 0) {
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        first += 16;
+    }
+    return scalar::find_byte(first, last, c);
+}
+
+// Classifies 16 bytes at once through two pshufb lookups on the nibbles
+__attribute__((target("sse4.2")))
+const char* skip(const char* first, const char* last, const char_set& set) {
+    const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(set.lo.data()));
+    const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(set.hi.data()));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_setzero_si128();
+    while (last - first >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i lo_bits = _mm_shuffle_epi8(lo, _mm_and_si128(chunk, nibble));
+        __m128i hi_bits = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble));
+        __m128i outside = _mm_cmpeq_epi8(_mm_and_si128(lo_bits, hi_bits), zero);
+        if (int mask = _mm_movemask_epi8(outside); mask != 0) {
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        first += 16;
+    }
+    return scalar::skip(first, last, set);
+}
+
+constexpr kernels table{find_byte, skip};
+
+} // namespace sse42
+
+namespace avx2 {
+
+__attribute__((target("avx2")))
+const char* find_byte(const char* first, const char* last, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    while (last - first >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        if (unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle))); mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+        first += 32;
+    }
+    // the 128 bit tail is done here rather than by calling the sse4.2
+    // kernel, mixing legacy SSE with dirty upper AVX state stalls
+    if (last - first >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        if (int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(needle))); mask != 0) {
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        first += 16;
+    }
+    return scalar::find_byte(first, last, c);
+}
+
+__attribute__((target("avx2")))
+const char* skip(const char* first, const char* last, const char_set& set) {
+    // vpshufb looks up within each 128 bit lane, so both lanes get the tables
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(set.lo.data())));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(set.hi.data())));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    while (last - first >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        __m256i lo_bits = _mm256_shuffle_epi8(lo, _mm256_and_si256(chunk, nibble));
+        __m256i hi_bits = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+        __m256i outside = _mm256_cmpeq_epi8(_mm256_and_si256(lo_bits, hi_bits), zero);
+        if (unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(outside)); mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+        first += 32;
+    }
+    if (last - first >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i lo_bits = _mm_shuffle_epi8(_mm256_castsi256_si128(lo), _mm_and_si128(chunk, _mm256_castsi256_si128(nibble)));
+        __m128i hi_bits = _mm_shuffle_epi8(_mm256_castsi256_si128(hi), _mm_and_si128(_mm_srli_epi16(chunk, 4), _mm256_castsi256_si128(nibble)));
+        __m128i outside = _mm_cmpeq_epi8(_mm_and_si128(lo_bits, hi_bits), _mm_setzero_si128());
+        if (int mask = _mm_movemask_epi8(outside); mask != 0) {
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        first += 16;
+    }
+    return scalar::skip(first, last, set);
+}
+
+constexpr kernels table{find_byte, skip};
+
+} // namespace avx2
+
+#endif
+
+} // namespace
+
+bool supported(isa level) {
+    switch (level) {
+#if defined(__x86_64__)
+        case isa::avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        case isa::sse42:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2");
+#endif
+        case isa::scalar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+isa best_isa() {
+    for (auto level : {isa::avx2, isa::sse42}) {
+        if (supported(level)) {
+            return level;
+        }
+    }
+    return isa::scalar;
+}
+
+const kernels& kernels_for(isa level) {
+    switch (level) {
+#if defined(__x86_64__)
+        case isa::avx2:
+            return avx2::table;
+        case isa::sse42:
+            return sse42::table;
+#endif
+        default:
+            return scalar::table;
+    }
+}
+
+} // namespace http::scan
@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Byte scanning kernels for the HTTP parser. Every kernel has a scalar,
+// an SSE4.2 and an AVX2 version, the best one the cpu supports is picked
+// on first use.
+namespace http::scan {
+
+// Set of ASCII bytes, usable both as a lookup table and by the vector
+// kernels: a byte c is in the set iff lo[c & 0xf] & hi[c >> 4] != 0.
+// Only the high nibbles 0-7 get a bit, so bytes >= 0x80 are never in it.
+struct char_set {
+    constexpr explicit char_set(std::string_view chars) {
+        for (unsigned char c : chars) {
+            if (c < 0x80) {
+                this->table[c] = true;
+                this->lo[c & 0xf] |= static_cast<uint8_t>(1u << (c >> 4));
+            }
+        }
+        for (size_t h = 0; h < 8; ++h) {
+            this->hi[h] = static_cast<uint8_t>(1u << h);
+        }
+    }
+
+    constexpr bool contains(char c) const {
+        return this->table[static_cast<unsigned char>(c)];
+    }
+
+    std::array<bool, 256>   table{};
+    alignas(16) std::array<uint8_t, 16> lo{};
+    alignas(16) std::array<uint8_t, 16> hi{};
+};
+
+enum class isa {
+    scalar,
+    sse42,
+    avx2,
+};
+
+struct kernels {
+    // First `c` in [first, last), or last
+    const char* (*find_byte)(const char* first, const char* last, char c);
+    // First byte in [first, last) that is not in `set`, or last
+    const char* (*skip)(const char* first, const char* last, const char_set& set);
+};
+
+bool supported(isa level);
+
+// The highest level supported by the cpu
+isa best_isa();
+
+const kernels& kernels_for(isa level);
+
+inline const kernels*& active() {
+    static const kernels* current = &kernels_for(best_isa());
+    return current;
+}
+
+// Switches the kernels used by the functions below, meant for tests and
+// benchmarks. Not thread safe, the level must be supported.
+inline void use(isa level) {
+    active() = &kernels_for(level);
+}
+
+inline const char* find_byte(const char* first, const char* last, char c) {
+    return active()->find_byte(first, last, c);
+}
+
+inline const char* skip(const char* first, const char* last, const char_set& set) {
+    return active()->skip(first, last, set);
+}
+
+inline size_t find_byte(std::string_view str, char c) {
+    auto it = find_byte(str.data(), str.data() + str.size(), c);
+    return it == str.data() + str.size() ? std::string_view::npos : static_cast<size_t>(it - str.data());
+}
+
+// Length of the prefix of `str` made of bytes in `set`
+inline size_t span(std::string_view str, const char_set& set) {
+    return static_cast<size_t>(skip(str.data(), str.data() + str.size(), set) - str.data());
+}
+
+// Position of the first CRLF in `str`, or npos. A trailing CR alone does
+// not count, its LF may still be on its way.
+inline size_t find_crlf(std::string_view str) {
+    const char* first = str.data();
+    const char* last = str.data() + str.size();
+    while (true) {
+        first = find_byte(first, last, '\r');
+        if (last - first < 2) {
+            return std::string_view::npos;
+        }
+        if (first[1] == '\n') {
+            return static_cast<size_t>(first - str.data());
+        }
+        ++first;
+    }
+}
+
+} // namespace http::scan
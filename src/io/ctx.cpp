@@ -1,10 +1,13 @@
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <optional>
+#include <span>
 #include <print>
 #include <thread>
 #include <csignal>
@@ -18,6 +21,7 @@
 namespace io::detail {
     
 using std::chrono::operator""ms;
+using std::chrono::operator""s;
 using std::chrono::operator""ns;
 
 
@@ -25,22 +29,35 @@ void ctx::worker(std::stop_token st){
 
     size_t submit_count = 0;
     size_t pending_req_count = 0;
+    auto last_trim = std::chrono::steady_clock::now();
     while (!st.stop_requested()) {
 
-        if (unp_sem.try_acquire_for(25ms)) {
-            auto req = unprocessed_requests.pop_front();
-            auto& [helper_ptr, ring_handle] = req.value();
-            submit_count += ring_handle(helper_ptr, &ring);
+        std::array<request, submit_threshold> reqs;
+        size_t n = unprocessed_requests.pop_bulk(reqs.begin(), reqs.size());
+        // Only park when nothing is left to flush, the timeout keeps the
+        // stop token checked
+        if (n == 0 && submit_count == 0) {
+            n = unprocessed_requests.pop_bulk_wait_for(reqs.begin(), reqs.size(), 25ms);
+            // Idle, give back the user data the last interval did not need
+            if (n == 0 && std::chrono::steady_clock::now() - last_trim >= 1s) {
+                this->usr_data_pool.trim_idle();
+                last_trim = std::chrono::steady_clock::now();
+            }
+        }
+        if (n > 0) {
+            for (auto& [helper_ptr, ring_handle] : std::span(reqs).first(n)) {
+                submit_count += ring_handle(helper_ptr, &ring);
 
-            pending_req_count++;
+                pending_req_count++;
             
-            if (submit_count >= submit_threshold) {
-                auto submit_ret = io_uring_submit(&ring);
-                if (submit_ret < 0) {
-                    logging::async::error("io_uring_submit failed: {}", strerror(-submit_ret));
-                } else {
-                    logging::async::debug("Submitted {} requests to io_uring", submit_ret);
-                    submit_count = 0;
+                if (submit_count >= submit_threshold) {
+                    auto submit_ret = io_uring_submit(&ring);
+                    if (submit_ret < 0) {
+                        logging::async::error("io_uring_submit failed: {}", strerror(-submit_ret));
+                    } else {
+                        logging::async::debug("Submitted {} requests to io_uring", submit_ret);
+                        submit_count = 0;
+                    }
                 }
             }
         } else {
@@ -65,6 +82,10 @@ void ctx::worker(std::stop_token st){
 size_t ctx::handle_reqs(io_uring_cqe* cqe) {
     size_t processed_req_count = 0;
 
+    // resumed in batches, one run queue reservation per batch
+    std::array<std::coroutine_handle<>, 64> ready;
+    size_t ready_count = 0;
+
     uint32_t head, count = 0;
     io_uring_for_each_cqe(&ring, head, cqe) {
         count++;
@@ -73,7 +94,11 @@ size_t ctx::handle_reqs(io_uring_cqe* cqe) {
             [&]<typename T>(T& usr_data) {
                 if constexpr (std::is_same_v<T, io_usr_data>) {
                     usr_data.io_ret->store(cqe->res, std::memory_order_release); // Copy the cqe result to the user data
-                    coro::thread::dispatch(usr_data.handle);
+                    ready[ready_count++] = usr_data.handle;
+                    if (ready_count == ready.size()) {
+                        coro::thread::dispatch_bulk(ready);
+                        ready_count = 0;
+                    }
                     processed_req_count++;
                 } else if constexpr (std::is_same_v<T, timeout_usr_data>) {
                     switch (cqe->res) {
@@ -95,6 +120,7 @@ size_t ctx::handle_reqs(io_uring_cqe* cqe) {
         this->usr_data_pool.deallocate(data); // Clean up the user data
     }
     io_uring_cq_advance(&ring, count);
+    coro::thread::dispatch_bulk(std::span(ready).first(ready_count));
 
     return processed_req_count;
 }
@@ -138,8 +164,7 @@ void ctx::clean_up() {
     // Clean up remaining requests
 
     size_t pending_req_count = 0;
-    while (unp_sem.try_acquire_for(5ms)) {
-        auto req = unprocessed_requests.pop_front();
+    while (auto req = unprocessed_requests.pop_front_wait_for(5ms)) {
         auto& [helper_ptr, ring_handle] = req.value();
         ring_handle(helper_ptr, &ring);
         pending_req_count++;
@@ -7,13 +7,13 @@
 #include <liburing.h>
 #include <cstdint>
 #include <print>
-#include <semaphore>
 #include <thread>
 #include <stop_token>
 #include <cstring>
 #include <utility>
-#include "concurrent/mpsc_queue.h"
-#include "concurrent/spsc_object_pool.h"
+#include "concurrent/mpsc_lanes.h"
+#include "concurrent/object_pool.h"
+#include "concurrent/waitable_queue.h"
 
 
 namespace io::detail {
@@ -142,6 +142,10 @@ public:
         return data_ptr;
     }
 
+    concurrent::object_pool_stats usr_data_stats() const {
+        return this->usr_data_pool.stats();
+    }
+
     int32_t register_file_alloc_range(uint32_t off, uint32_t len) {
         return io_uring_register_file_alloc_range(&ring, off, len);
     }
@@ -160,7 +164,6 @@ public:
     bool submit(void* helper_ptr, auto (*ring_handle)(void*, io_uring*) -> int) {
         if (this->is_worker_running.load(std::memory_order_acquire)){
             this->unprocessed_requests.emplace_back(helper_ptr, ring_handle);
-            this->unp_sem.release();            
             return true;
         }
         return false;
@@ -189,7 +192,6 @@ private:
 
     ctx(uint32_t entries = 128, uint32_t flags = 0) : 
         pending_req_count{0}, 
-        unp_sem{0}, 
         usr_data_pool{1024*128} 
     {
         if(io_uring_queue_init(entries, &ring, flags) < 0) {
@@ -209,10 +211,13 @@ private:
     std::atomic<bool> is_worker_running;
     alignas(64) std::atomic<size_t> pending_req_count;
 
-    alignas(64) std::counting_semaphore<> unp_sem;
-    concurrent::mpsc_queue<request> unprocessed_requests;
+    // One lane per submitting thread, so workers do not contend with each
+    // other. The worker parks here when idle, submit only pays for a
+    // wake-up while it actually sleeps
+    alignas(64) concurrent::waitable_queue<concurrent::mpsc_lanes<request>> unprocessed_requests;
 
-    concurrent::spsc_object_pool<usr_data> usr_data_pool;
+    // Allocated by whichever thread suspends, freed by the worker
+    concurrent::object_pool<usr_data> usr_data_pool;
 };
 
 }
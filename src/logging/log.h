@@ -15,6 +15,7 @@
 #include "logging/common.h"
 
 #include "concurrent/mpsc_ringbuffer.h"
+#include "concurrent/waitable_queue.h"
 
 namespace logging {
 
@@ -101,7 +102,7 @@ public:
             std::this_thread::sleep_for(10ms);
         }
         this->worker_thread.request_stop();
-        this->sem.release(); 
+        this->ringbuffer.wake_all();
     }
 
     static auto& get_instance() {
@@ -130,17 +131,12 @@ public:
     }
 
     bool submit_packets(std::vector<packet>&& pkts) {
-        if (ringbuffer.emplace_back(std::move(pkts))) {
-            sem.release();
-            return true;
-        }
-        return false;
+        return ringbuffer.emplace_back(std::move(pkts));
     }
 private:
     void loop(std::stop_token st){
-        while(sem.acquire(), !st.stop_requested()){
-            auto pkts = ringbuffer.unsafe_pop_front();
-            for (auto& p : pkts) {
+        while (auto pkts = ringbuffer.pop_front_wait([&]{ return st.stop_requested(); })) {
+            for (auto& p : *pkts) {
                 for (auto& sink : sinks) {
                     p.to(*sink);
                 }
@@ -150,8 +146,7 @@ private:
     std::mutex    mutex{};    
     std::vector<std::unique_ptr<sink::basic>> sinks{};
 
-    alignas(64) std::counting_semaphore<> sem{0};
-    concurrent::mpsc_ringbuffer<std::vector<packet>, 1024> ringbuffer{};
+    alignas(64) concurrent::waitable_queue<concurrent::mpsc_ringbuffer<std::vector<packet>, 1024>> ringbuffer{};
     std::jthread worker_thread{
         [this](std::stop_token st){
             this->loop(st);
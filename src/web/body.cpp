@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <utility>
+
+#include "io/awaiter.h"
+#include "web/body.h"
+
+namespace web {
+
+coro::awaitable_task<std::string_view> body_stream::next() {
+    if (!this->pending.empty()) {
+        co_return std::exchange(this->pending, {});
+    }
+    while (this->parser.reading_body()) {
+        if (this->unparsed.empty()) {
+            auto buffer = this->buffers.get(this->buffer_index);
+            int32_t bytes_read{};
+            if (this->read_hook == nullptr) {
+                bytes_read = co_await io::awaiter::link_timeout{
+                    io::awaiter::read{this->fd, buffer.data(), buffer.size()},
+                    this->timeout
+                };
+            } else {
+                bytes_read = co_await this->read_hook(this->fd, buffer);
+            }
+            if (bytes_read <= 0) {
+                this->read_failed = true;
+                co_return std::string_view{};
+            }
+            // whatever follows the body is parsed out of this buffer now
+            this->buffers.current = this->buffer_index;
+            this->unparsed = {buffer.data(), static_cast<size_t>(bytes_read)};
+        }
+        if (auto piece = this->parser.read_body(this->unparsed); !piece.empty()) {
+            co_return piece;
+        }
+    }
+    co_return std::string_view{};
+}
+
+coro::awaitable_task<size_t> body_stream::read(std::span<char> out) {
+    auto piece = co_await this->next();
+    size_t size = std::min(piece.size(), out.size());
+    piece.copy(out.data(), size);
+    this->pending = piece.substr(size);
+    co_return size;
+}
+
+coro::awaitable_task<std::optional<std::string_view>> body_stream::collect(std::string& out, size_t limit) {
+    out.clear();
+    while (!this->done()) {
+        auto piece = co_await this->next();
+        if (piece.empty()) {
+            break;
+        }
+        if (out.size() + piece.size() > limit) {
+            out.append(piece);
+            this->pending = out;
+            co_return std::nullopt;
+        }
+        if (out.empty() && this->done()) {
+            co_return piece;
+        }
+        out.append(piece);
+    }
+    if (this->failed()) {
+        co_return std::nullopt;
+    }
+    co_return std::string_view{out};
+}
+
+coro::awaitable_task<bool> body_stream::drain() {
+    while (!this->done() && !this->failed()) {
+        co_await this->next();
+    }
+    co_return !this->failed();
+}
+
+} // namespace web
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "coro/awaitable_task.h"
+#include "http/request.h"
+
+namespace web {
+
+// The two read buffers of a connection. Requests are parsed out of the
+// `current` one, a streamed body is read into the other so that the
+// header views of its request stay intact while the handler runs.
+struct read_buffers {
+    static constexpr size_t buffer_size = 8192;
+
+    std::span<char> get(size_t index) {
+        return this->data[index];
+    }
+
+    std::array<std::array<char, buffer_size>, 2> data;
+    size_t                                       current{0};
+};
+
+// Body of a request that the parser left to be streamed. Pieces point into
+// the connection's read buffers and stay valid until the next call, so an
+// upload of any size goes through in constant memory.
+//
+//     auto* body = co_await web::response::task::get_body{};
+//     for (auto piece = co_await body->next(); !piece.empty(); piece = co_await body->next()) {
+//         ...
+//     }
+class body_stream {
+public:
+    // Stands in for the socket read, meant for tests
+    using read_t = coro::awaitable_task<int32_t> (*)(int32_t fd, std::span<char> buffer);
+
+    body_stream(
+        http::request::parser&    parser,
+        read_buffers&             buffers,
+        std::string_view&         unparsed,
+        int32_t                   fd,
+        std::chrono::milliseconds timeout,
+        read_t                    read = nullptr
+    ) : parser(parser),
+        buffers(buffers),
+        unparsed(unparsed),
+        fd(fd),
+        timeout(timeout),
+        read_hook(read),
+        buffer_index(1 - buffers.current)
+    {}
+    body_stream(const body_stream&) = delete;
+    body_stream& operator=(const body_stream&) = delete;
+
+    // Next piece of the body, empty once it is over or has failed
+    coro::awaitable_task<std::string_view> next();
+
+    // Copies up to out.size() bytes of the body, 0 once it is over
+    coro::awaitable_task<size_t> read(std::span<char> out);
+
+    // The whole body if it is at most `limit` bytes, a view into the read
+    // buffer when it came in one piece and into `out` otherwise. A longer
+    // body is not lost, what was collected of it is handed out again first.
+    coro::awaitable_task<std::optional<std::string_view>> collect(std::string& out, size_t limit);
+
+    // Reads through whatever the handler left, false if the connection
+    // cannot go on with the next request
+    coro::awaitable_task<bool> drain();
+
+    bool done() const {
+        return !this->parser.reading_body() && this->pending.empty();
+    }
+
+    bool failed() const {
+        return this->read_failed || this->parser.body_failed();
+    }
+
+    // Trailers of a chunked body, there once done()
+    const http::request::trailer& trailers() const {
+        return this->parser.trailers();
+    }
+
+private:
+    http::request::parser&    parser;
+    read_buffers&             buffers;
+    std::string_view&         unparsed;
+    int32_t                   fd;
+    std::chrono::milliseconds timeout;
+    read_t                    read_hook;
+    size_t                    buffer_index;
+    // handed out before anything else is read
+    std::string_view          pending{};
+    bool                      read_failed{false};
+};
+
+} // namespace web
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <cstddef>
 #include <filesystem>
 #include <string_view>
@@ -23,6 +24,18 @@ inline size_t& max_worker_conn(){
     return loop::env::max_worker_conn();
 }
 
+inline size_t& max_buffered_body(){
+    return loop::env::max_buffered_body();
+}
+
+inline http::request::limits& request_limits(){
+    return loop::env::request_limits();
+}
+
+inline std::chrono::milliseconds& header_timeout(){
+    return loop::env::header_timeout();
+}
+
 inline std::filesystem::path& root_path(){
     return routing::env::root_path();
 }
@@ -59,6 +72,21 @@ struct chain {
         return *this;
     }
 
+    chain& set_max_buffered_body(size_t size) {
+        max_buffered_body() = size;
+        return *this;
+    }
+
+    chain& set_request_limits(const http::request::limits& limits) {
+        request_limits() = limits;
+        return *this;
+    }
+
+    chain& set_header_timeout(std::chrono::milliseconds timeout) {
+        header_timeout() = timeout;
+        return *this;
+    }
+
     chain& set_index_files(std::vector<std::string> files) {
         index_files() = std::move(files);
         return *this;
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <csignal>
+#include <optional>
 #include <print>
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -15,6 +19,7 @@
 #include "coro/thread.h"
 
 #include "web/loop.h"
+#include "web/body.h"
 #include "web/response.h"
 #include "web/routing.h"
 
@@ -29,59 +34,151 @@ std::vector<io::fd>& accepter_fds(){
 
 
 using namespace std::literals;
+
+namespace {
+http::response::status_code status_for(http::request::error error) {
+    switch (error) {
+        case http::request::error::request_line_too_long:
+            return http::response::status_code::uri_too_long;
+        case http::request::error::header_too_large:
+            return http::response::status_code::request_header_fields_too_large;
+        case http::request::error::body_too_large:
+            return http::response::status_code::content_too_large;
+        default:
+            return http::response::status_code::bad_request;
+    }
+}
+}
+
 coro::simple_task async_handle_connection(int fd, ip::v4 a) {
     io::fd fd_w(fd);
     ip::v4 client_addr = a;
     co_await coro::thread::dispatch_awaiter{};
 
-    char read_buffer[8192];
-
     auto timeout = 200ms;
 
-    while (true) {
-        auto parser = http::request::parser{};
+    // lives as long as the connection, whatever a read brought beyond the
+    // current request is kept for the next one
+    http::request::parser parser{env::request_limits(), http::request::body_mode::stream};
+    web::read_buffers buffers;
+    std::string_view unparsed{};
+    // bodies read ahead of the handler, when they did not come in one piece
+    std::string body_buffer{};
+    // responses to the requests of one read, written out together
+    web::response::batch out{};
+    // once the head of a request started arriving it has to be complete by
+    // then, each read on its own would let a slow client go on forever
+    std::optional<std::chrono::steady_clock::time_point> head_deadline{};
 
+    while (true) {
         while (parser.empty()) {
+            if (!unparsed.empty()) {
+                unparsed.remove_prefix(parser.feed(unparsed));
+                continue;
+            }
+            // every request read so far is answered, so the answers go out
+            // before waiting on the client again
+            if (!out.empty() && co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout}) < 0) {
+                co_return;
+            }
+            auto read_timeout = timeout;
+            if (parser.reading_head()) {
+                auto now = std::chrono::steady_clock::now();
+                if (!head_deadline) {
+                    head_deadline = now + env::header_timeout();
+                }
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(*head_deadline - now);
+                read_timeout = std::clamp(left, 1ms, timeout);
+            }
+            auto buffer = buffers.get(buffers.current);
             int32_t bytes_read = co_await io::awaiter::link_timeout{
-                io::awaiter::read{fd_w.get(), read_buffer, sizeof(read_buffer)},
-                timeout
+                io::awaiter::read{fd_w.get(), buffer.data(), buffer.size()},
+                read_timeout
             };
 
             if (bytes_read <= 0) {
+                if (head_deadline && std::chrono::steady_clock::now() >= *head_deadline) {
+                    logging::async::error("Request head from {} took too long", client_addr.to_string());
+                    co_await web::response::error(http::response::status_code::request_timeout)
+                                .settings({fd_w.get(), client_addr, timeout})
+                                .output(&out);
+                    co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout});
+                    co_return;
+                }
                 logging::async::error("Failed to read from {}: {}", 
                     client_addr.to_string(), io::error::msg
                 );
                 co_return;
             } else {
-                parser.feed({
-                    read_buffer, 
-                    static_cast<size_t>(bytes_read)
-                });
+                unparsed = {buffer.data(), static_cast<size_t>(bytes_read)};
             }
         }
 
+        head_deadline.reset();
+
         if (auto result = parser.pop_front(); result.has_value()) {
 
             auto& request = result.value();
 
-            if (auto it = request.header.find("Connection"); it != request.header.end()) {
-                if (it->second == "close") {
-                    co_return; // Close connection immediately
-                } else if (it->second == "keep-alive") {
-                    timeout = 1000ms; // Keep-alive timeout
+            if (auto connection = request.header[http::request::known_field::connection]; http::request::iequals(connection, "close")) {
+                if (!out.empty()) {
+                    co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout});
+                }
+                co_return; // Close connection immediately
+            } else if (http::request::iequals(connection, "keep-alive")) {
+                timeout = 1000ms; // Keep-alive timeout
+            }
+
+            std::optional<web::body_stream> body{};
+            if (request.body_follows) {
+                // reading the body may wait on a client that waits on these
+                if (!out.empty() && co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout}) < 0) {
+                    co_return;
+                }
+                body.emplace(parser, buffers, unparsed, fd_w.get(), timeout);
+                // small bodies are handed over whole, like before streaming
+                if (auto whole = co_await body->collect(body_buffer, env::max_buffered_body()); whole) {
+                    request.body = *whole;
+                    request.trailer = body->trailers();
+                    request.body_follows = false;
+                } else if (body->failed()) {
+                    logging::async::error("Failed to read the body from {}", client_addr.to_string());
+                    if (parser.body_failed()) {
+                        co_await web::response::error(status_for(parser.pop_front().error()))
+                                    .settings({fd_w.get(), client_addr, timeout})
+                                    .output(&out);
+                        co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout});
+                    }
+                    co_return;
                 }
             }
 
             co_await routing::detail::route(request)
-                        .settings({fd_w.get(), client_addr, timeout});
+                        .settings({fd_w.get(), client_addr, timeout})
+                        .body(request.body_follows ? &*body : nullptr)
+                        .output(&out);
             // TODO: Handle errors in response sending
             // For now, we assume response sending is always successful
 
+            if (out.size() >= web::response::batch::flush_threshold
+                && co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout}) < 0) {
+                co_return;
+            }
+
+            // the next request starts after whatever the handler left unread
+            if (body && !co_await body->drain()) {
+                co_return;
+            }
+            if (body_buffer.capacity() > env::max_buffered_body()) {
+                body_buffer = std::string{};
+            }
 
         } else {
             logging::async::error("Failed to parse request from {}", client_addr.to_string());
-            co_await web::response::error(http::response::status_code::bad_request)
-                        .settings({fd_w.get(), client_addr, timeout});
+            co_await web::response::error(status_for(result.error()))
+                        .settings({fd_w.get(), client_addr, timeout})
+                        .output(&out);
+            co_await web::response::flush(out).settings({fd_w.get(), client_addr, timeout});
             co_return;
         }
 
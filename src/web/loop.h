@@ -1,6 +1,8 @@
 #pragma once
+#include <chrono>
 #include <cstddef>
 
+#include "http/request.h"
 #include "io/io.h"
 #include "web/ip.h"
 #include "coro/simple_task.h"
@@ -28,5 +30,26 @@ inline size_t& max_worker_conn(){
     static size_t max_worker_conn = 128;
     return max_worker_conn;
 }
+
+// Request bodies up to this size are read into msg::body before the
+// handler runs, larger ones are streamed to it
+inline size_t& max_buffered_body(){
+    static size_t max_buffered_body = 64 * 1024;
+    return max_buffered_body;
+}
+
+// What a single request may take up on a connection, exceeding it is
+// answered with 413, 414 or 431 before the request is complete
+inline http::request::limits& request_limits(){
+    static http::request::limits request_limits{};
+    return request_limits;
+}
+
+// Time a client has to send the head of a request once it started, however
+// steadily the bytes trickle in
+inline std::chrono::milliseconds& header_timeout(){
+    static std::chrono::milliseconds header_timeout{10'000};
+    return header_timeout;
+}
 } // namespace env
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "io/awaiter.h"
+#include "web/multipart.h"
+
+namespace web {
+
+using event = http::multipart::parser::event;
+
+coro::awaitable_task<event> multipart_reader::next_event() {
+    while (true) {
+        auto ev = this->parser.next(this->input);
+        if (ev.kind != event::kind_t::need_more) {
+            if (ev.kind == event::kind_t::failed) {
+                this->malformed = true;
+            }
+            co_return ev;
+        }
+        // a body that ends before the closing boundary is cut short, no ?:
+        // here as some GCC versions run a co_await in the branch not taken
+        if (this->stream == nullptr) {
+            this->input = {};
+        } else {
+            this->input = co_await this->stream->next();
+        }
+        if (this->input.empty()) {
+            this->malformed = true;
+            co_return event{event::kind_t::failed};
+        }
+    }
+}
+
+coro::awaitable_task<const http::multipart::part*> multipart_reader::next_part() {
+    while (this->in_part) {
+        co_await this->read();
+    }
+    if (this->malformed) {
+        co_return nullptr;
+    }
+    auto ev = co_await this->next_event();
+    if (ev.kind != event::kind_t::part) {
+        co_return nullptr;
+    }
+    this->in_part = true;
+    co_return &this->parser.current();
+}
+
+coro::awaitable_task<std::string_view> multipart_reader::read() {
+    if (!this->in_part) {
+        co_return std::string_view{};
+    }
+    auto ev = co_await this->next_event();
+    if (ev.kind == event::kind_t::data) {
+        co_return ev.data;
+    }
+    this->in_part = false;
+    co_return std::string_view{};
+}
+
+coro::awaitable_task<std::optional<size_t>> multipart_reader::save(int32_t fd) {
+    co_return co_await this->save([fd](const char* data, uint32_t size, size_t offset) {
+        return io::awaiter::write{fd, data, size, offset};
+    });
+}
+
+} // namespace web
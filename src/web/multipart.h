@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "coro/awaitable_task.h"
+#include "http/multipart.h"
+#include "web/body.h"
+
+namespace web {
+
+// The parts of a multipart/form-data request, read as the body comes in.
+// `stream` is what get_body gave the handler, nullptr when the body was
+// small enough to be buffered into `buffered`.
+//
+//     auto boundary = http::multipart::boundary(msg.header["Content-Type"]);
+//     web::multipart_reader form{*boundary, co_await web::response::task::get_body{}, msg.body};
+//     while (auto* part = co_await form.next_part()) {
+//         if (part->is_file()) {
+//             co_await form.save(fd);
+//         }
+//     }
+class multipart_reader {
+public:
+    multipart_reader(
+        std::string_view        boundary,
+        web::body_stream*       stream,
+        std::string_view        buffered,
+        http::multipart::limits limit = {}
+    ) : parser(boundary, limit),
+        stream(stream),
+        input(stream ? std::string_view{} : buffered)
+    {}
+    multipart_reader(const multipart_reader&) = delete;
+    multipart_reader& operator=(const multipart_reader&) = delete;
+
+    // Skips what is left of the current part, nullptr once the body is over
+    // or turned out malformed
+    coro::awaitable_task<const http::multipart::part*> next_part();
+
+    // Next piece of the current part's body, empty at its end. Pieces stay
+    // valid until the next call.
+    coro::awaitable_task<std::string_view> read();
+
+    // Writes the rest of the current part to `fd` from offset 0, straight
+    // out of the read buffers. The bytes written, nullopt if a write or the
+    // body failed.
+    coro::awaitable_task<std::optional<size_t>> save(int32_t fd);
+
+    // The same through `write(data, size, offset)`, which gives an
+    // awaitable of the bytes written or <= 0 like io::awaiter::write
+    template<typename write_t>
+    coro::awaitable_task<std::optional<size_t>> save(write_t write);
+
+    bool failed() const {
+        return this->malformed;
+    }
+
+private:
+    coro::awaitable_task<http::multipart::parser::event> next_event();
+
+    http::multipart::parser parser;
+    web::body_stream*       stream;
+    std::string_view        input;
+    bool                    in_part{false};
+    bool                    malformed{false};
+};
+
+template<typename write_t>
+coro::awaitable_task<std::optional<size_t>> multipart_reader::save(write_t write) {
+    size_t offset = 0;
+    for (auto piece = co_await this->read(); !piece.empty(); piece = co_await this->read()) {
+        while (!piece.empty()) {
+            int32_t written = co_await write(piece.data(), static_cast<uint32_t>(piece.size()), offset);
+            if (written <= 0) {
+                co_return std::nullopt;
+            }
+            piece.remove_prefix(written);
+            offset += written;
+        }
+    }
+    if (this->malformed) {
+        co_return std::nullopt;
+    }
+    co_return offset;
+}
+
+} // namespace web
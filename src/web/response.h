@@ -4,13 +4,85 @@
 #include <coroutine>
 #include <chrono>
 #include <cstdint>
+#include <span>
+#include <vector>
+
+#include <sys/uio.h>
 
 #include "io/io.h"
 #include "web/ip.h"
 #include "http/response.h"
 
+namespace web {
+class body_stream;
+}
+
 namespace web::response {
 
+// What is left of `iov` once `written` bytes of it went out. The entry a
+// write stopped in is moved past its written part, the entries before it
+// are dropped, as are empty ones left at the front.
+inline std::span<iovec> consume(std::span<iovec> iov, size_t written) {
+    while (!iov.empty() && written >= iov.front().iov_len) {
+        written -= iov.front().iov_len;
+        iov = iov.subspan(1);
+    }
+    if (!iov.empty() && written > 0) {
+        iov.front().iov_base = static_cast<char*>(iov.front().iov_base) + written;
+        iov.front().iov_len -= written;
+    }
+    return iov;
+}
+
+// Responses to pipelined requests, gathered while more requests are queued
+// behind them and written out together once the queue runs dry. Holds
+// copies, so what the handlers formatted may go away in the meantime.
+class batch {
+public:
+    // written out before it grows past this
+    static constexpr size_t flush_threshold = 64 * 1024;
+    // larger bodies go out straight from the handler's memory, together
+    // with whatever is gathered ahead of them
+    static constexpr size_t max_copied_body = 16 * 1024;
+
+    void append(const void* data, size_t size) {
+        auto first = static_cast<const char*>(data);
+        this->bytes.insert(this->bytes.end(), first, first + size);
+    }
+
+    // Puts a header and body behind what is gathered. A small body is
+    // copied in, and nothing is returned. A larger one is laid out in `iov`,
+    // after the gathered bytes, to go out in one writev. The batch is
+    // cleared once that is written.
+    std::span<iovec> gather(std::span<const char> header, std::span<const std::byte> body, std::span<iovec, 3> iov) {
+        if (body.size() <= max_copied_body) {
+            this->append(header.data(), header.size());
+            this->append(body.data(), body.size());
+            return {};
+        }
+        iov[0] = {this->bytes.data(), this->bytes.size()};
+        iov[1] = {const_cast<char*>(header.data()), header.size()};
+        iov[2] = {const_cast<std::byte*>(body.data()), body.size()};
+        return iov;
+    }
+
+    std::span<char> data() {
+        return this->bytes;
+    }
+
+    size_t size() const { return this->bytes.size(); }
+    bool empty() const { return this->bytes.empty(); }
+
+    void clear() {
+        this->bytes.clear();
+        if (this->bytes.capacity() > 2 * flush_threshold) {
+            this->bytes.shrink_to_fit();
+        }
+    }
+
+private:
+    std::vector<char> bytes{};
+};
 
 struct task {
 public:
@@ -50,6 +122,8 @@ public:
         std::coroutine_handle<>     previous{std::noop_coroutine()};
 
         settings                   sets{}; 
+        web::body_stream*          body{nullptr};
+        response::batch*           out{nullptr};
     };
 
     struct get_settings{
@@ -63,6 +137,34 @@ public:
 
         promise_type* promise;
     };    
+
+    // The body of the request being handled when it is streamed rather
+    // than in msg::body, nullptr otherwise
+    struct get_body{
+        auto await_ready() { return false;}
+
+        bool await_suspend(std::coroutine_handle<promise_type> handle) {
+            this->promise = &handle.promise();
+            return false;
+        }
+        web::body_stream* await_resume() {return promise->body;}
+
+        promise_type* promise;
+    };
+
+    // Where the response goes when it is batched, nullptr when it is to
+    // be written right away
+    struct get_output{
+        auto await_ready() { return false;}
+
+        bool await_suspend(std::coroutine_handle<promise_type> handle) {
+            this->promise = &handle.promise();
+            return false;
+        }
+        response::batch* await_resume() {return promise->out;}
+
+        promise_type* promise;
+    };
     
     struct awaiter{
         bool await_ready() { return false; }
@@ -76,6 +178,8 @@ public:
             requires std::derived_from<T, promise_type>
         auto await_suspend(std::coroutine_handle<T> h) {
             coro.promise().sets = h.promise().sets;
+            coro.promise().body = h.promise().body;
+            coro.promise().out = h.promise().out;
             coro.promise().previous = h;
             return coro;
         }
@@ -110,6 +214,16 @@ public:
         return *this;
     }
 
+    task& body(web::body_stream* stream){
+        this->handle.promise().body = stream;
+        return *this;
+    }
+
+    task& output(response::batch* out){
+        this->handle.promise().out = out;
+        return *this;
+    }
+
     awaiter operator co_await(){
         return awaiter{this->handle};
     }
@@ -122,6 +236,9 @@ private:
 
 task msg(const http::response::msg& msg);
 
+// Writes out what `out` gathered and clears it
+task flush(batch& out);
+
 task error(http::response::status_code code);
 
 task file_head(const std::string& content_type, size_t size);
@@ -1,5 +1,6 @@
 #include <cstddef>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <ranges>
@@ -20,7 +21,14 @@
 namespace web::routing {
 
 namespace detail {
-using router_map = std::unordered_map<std::string, router>;
+// looked up by the views the requests carry, without making a string first
+struct path_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view path) const {
+        return std::hash<std::string_view>{}(path);
+    }
+};
+using router_map = std::unordered_map<std::string, router, path_hash, std::equal_to<>>;
 
 
 template<typename request::method>
@@ -211,8 +219,10 @@ route_result route(const request::msg& req){
         auto& tree = dynamic_router_tree(req.line.method);
 
         std::error_code ec;
+        // only paths with escapes are copied, into here
+        std::string decode_buffer{};
         auto pct_decoded_path = http::pct_decode(
-            origin->path, ec
+            origin->path, decode_buffer, ec
         );
         
         if (ec) {
@@ -224,7 +234,7 @@ route_result route(const request::msg& req){
             return it->second(req);
         } else if (auto ret = 
                 tree.route(
-                    std::string_view{pct_decoded_path}
+                    pct_decoded_path
                         | std::views::split('/')
                         | std::views::transform([](auto &&rng) {
                             return std::string_view(rng);
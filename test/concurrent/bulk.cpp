@@ -0,0 +1,92 @@
+#include <boost/ut.hpp>
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpsc_queue.h"
+#include "concurrent/mpsc_ringbuffer.h"
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+
+template<typename queue_t>
+void single_thread_fifo() {
+    queue_t q;
+    std::vector<int> in(150);
+    std::iota(in.begin(), in.end(), 0);
+    q.emplace_back_bulk(std::views::take(in, 3));
+    q.emplace_back_bulk(in | std::views::drop(3));
+
+    std::vector<int> out;
+    expect(q.pop_bulk(std::back_inserter(out), 10) == 10_u);
+    while (q.pop_bulk(std::back_inserter(out), 7) > 0) {}
+    expect(out == in);
+    expect(!q.pop_front().has_value());
+}
+
+template<typename queue_t>
+void concurrent_batches(size_t consumers) {
+    queue_t q;
+    constexpr int producers = 4;
+    constexpr int batches = 2000;
+    constexpr int batch = 13;
+    const int total = producers * batches * batch;
+    std::atomic<int> consumed{0};
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q] {
+            std::array<int, batch> items{};
+            for (int b = 0; b < batches; ++b) {
+                std::iota(items.begin(), items.end(), b * batch);
+                q.emplace_back_bulk(items);
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::array<int, 32> out{};
+            while (consumed.load() < total) {
+                size_t n = q.pop_bulk(out.begin(), out.size());
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                sum += std::accumulate(out.begin(), out.begin() + n, 0L);
+                consumed += static_cast<int>(n);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    long per_producer = static_cast<long>(batches * batch) * (batches * batch - 1) / 2;
+    expect(consumed.load() == total);
+    expect(sum.load() == producers * per_producer);
+}
+
+suite<"bulk push and pop"> _ = [] {
+    "mpsc queue fifo"_test = [] { single_thread_fifo<mpsc_queue<int, 8>>(); };
+    "mpmc queue fifo"_test = [] { single_thread_fifo<mpmc_queue<int, 8>>(); };
+    "mpsc queue concurrent batches"_test = [] { concurrent_batches<mpsc_queue<int, 16>>(1); };
+    "mpmc queue concurrent batches"_test = [] { concurrent_batches<mpmc_queue<int, 16>>(4); };
+
+    "ringbuffer takes what fits"_test = [] {
+        mpsc_ringbuffer<int, 8> rb;
+        std::array<int, 5> items{1, 2, 3, 4, 5};
+        expect(rb.emplace_back_bulk(items) == 5_u);
+        expect(rb.emplace_back_bulk(items) == 3_u);
+        expect(rb.emplace_back_bulk(items) == 0_u);
+
+        std::array<int, 8> out{};
+        expect(rb.pop_bulk(out.begin(), 6) == 6_u);
+        expect(out[0] == 1 && out[4] == 5 && out[5] == 1);
+        expect(rb.pop_bulk(out.begin(), 8) == 2_u);
+        expect(out[0] == 2 && out[1] == 3);
+        expect(rb.size() == 0_u);
+    };
+};
+
+}
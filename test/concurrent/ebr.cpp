@@ -0,0 +1,106 @@
+#include <boost/ut.hpp>
+#include "concurrent/ebr.h"
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpsc_queue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+
+struct tracked {
+    static std::atomic<int> alive;
+    tracked() { ++alive; }
+    ~tracked() { --alive; }
+};
+std::atomic<int> tracked::alive{0};
+
+struct pinned_tracked {
+    static std::atomic<int> alive;
+    pinned_tracked() { ++alive; }
+    ~pinned_tracked() { --alive; }
+};
+std::atomic<int> pinned_tracked::alive{0};
+
+suite<"epoch based reclamation"> _ = [] {
+    "retired nodes are freed once unpinned"_test = [] {
+        epoch_manager em;
+        for (int i = 0; i < 1000; ++i) em.retire(new tracked{});
+        // at least the ones retired since the last scan are still there
+        expect(tracked::alive.load() >= static_cast<int>(1000 % ebr::max_retired_count));
+
+        expect(em.synchronize());
+        expect(tracked::alive.load() == 0);
+    };
+
+    "pinned thread holds back reclamation"_test = [] {
+        epoch_manager em;
+        em.protect<0>(nullptr);
+        std::thread([&em] {
+            for (int i = 0; i < 500; ++i) em.retire(new pinned_tracked{});
+        }).join();
+        for (int i = 0; i < 500; ++i) em.retire(new pinned_tracked{});
+        expect(pinned_tracked::alive.load() == 1000);
+        expect(!em.synchronize());
+        expect(pinned_tracked::alive.load() == 1000);
+
+        // the other thread's nodes were left behind as orphans
+        em.clear<0>();
+        expect(em.synchronize());
+        expect(pinned_tracked::alive.load() == 0);
+    };
+
+    "mpsc queue with epoch reclamation"_test = [] {
+        mpsc_queue<int, 8, epoch_manager> q;
+        constexpr int producers = 4;
+        constexpr int per_prod = 20000;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&q] {
+                for (int i = 0; i < per_prod; ++i) q.emplace_back(i);
+            });
+        }
+        int consumed = 0;
+        while (consumed < producers * per_prod) {
+            if (q.pop_front()) ++consumed; else std::this_thread::yield();
+        }
+        for (auto& th : threads) th.join();
+        expect(consumed == producers * per_prod);
+        expect(!q.pop_front().has_value());
+    };
+
+    "mpmc queue with epoch reclamation"_test = [] {
+        mpmc_queue<int, 8, epoch_manager> q;
+        constexpr int producers = 4;
+        constexpr int consumers = 4;
+        constexpr int per_prod = 20000;
+        const int total = producers * per_prod;
+        std::atomic<int> consumed{0};
+        std::atomic<long> sum{0};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&q] {
+                for (int i = 0; i < per_prod; ++i) q.emplace_back(i);
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                while (consumed.load() < total) {
+                    if (auto v = q.pop_front()) {
+                        sum += *v;
+                        ++consumed;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        expect(consumed.load() == total);
+        expect(sum.load() == static_cast<long>(producers) * per_prod * (per_prod - 1) / 2);
+    };
+};
+
+}
@@ -1,6 +1,7 @@
 #include <boost/ut.hpp>
 #include "concurrent/mpmc_queue.h"
 #include <atomic>
+#include <latch>
 #include <thread>
 #include <vector>
 namespace {
@@ -71,6 +72,67 @@ suite<"chunk optimized michael & scott's queue"> _ = [] {
         expect(CounterObj::ctor.load() + CounterObj::copy_ctor.load() + CounterObj::move_ctor.load() == CounterObj::dtor.load());
     };
 
+    "recycled chunks keep lifetimes balanced"_test = [] {
+        CounterObj::ctor.store(0);
+        CounterObj::dtor.store(0);
+        CounterObj::move_ctor.store(0);
+        CounterObj::copy_ctor.store(0);
+        {
+            mpmc_queue<CounterObj, 4, hazard_manager, 2> cached;
+            mpmc_queue<CounterObj, 4, hazard_manager, 0> uncached;
+            for (int round = 0; round < 50; ++round) {
+                for (int i = 0; i < 13; ++i) {
+                    cached.emplace_back(i);
+                    uncached.emplace_back(i);
+                }
+                for (int i = 0; i < 13; ++i) {
+                    auto a = cached.pop_front();
+                    auto b = uncached.pop_front();
+                    expect(a.has_value() && a->value == i);
+                    expect(b.has_value() && b->value == i);
+                }
+            }
+            // leave some in flight for the destructor
+            for (int i = 0; i < 7; ++i) cached.emplace_back(i);
+        }
+        expect(CounterObj::ctor.load() + CounterObj::copy_ctor.load() + CounterObj::move_ctor.load() == CounterObj::dtor.load());
+    };
+
+    "recycling under contention"_test = [] {
+        CounterObj::ctor.store(0);
+        CounterObj::dtor.store(0);
+        CounterObj::move_ctor.store(0);
+        CounterObj::copy_ctor.store(0);
+        constexpr int threads_per_side = 4;
+        constexpr int per_prod = 20000;
+        std::atomic<long> sum{0};
+        {
+            mpmc_queue<CounterObj, 4, hazard_manager, 2> q;
+            std::atomic<int> consumed{0};
+            std::latch start{2 * threads_per_side};
+            std::vector<std::thread> threads;
+            for (int p = 0; p < threads_per_side; ++p) {
+                threads.emplace_back([&] {
+                    start.arrive_and_wait();
+                    for (int i = 0; i < per_prod; ++i) q.emplace_back(i);
+                });
+                threads.emplace_back([&] {
+                    start.arrive_and_wait();
+                    while (consumed.load(std::memory_order_relaxed) < threads_per_side * per_prod) {
+                        if (auto v = q.pop_front()) {
+                            sum.fetch_add(v->value, std::memory_order_relaxed);
+                            consumed.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+            }
+            for (auto& t : threads) t.join();
+            expect(!q.pop_front().has_value());
+        }
+        expect(sum.load() == threads_per_side * (static_cast<long>(per_prod) * (per_prod - 1) / 2));
+        expect(CounterObj::ctor.load() + CounterObj::copy_ctor.load() + CounterObj::move_ctor.load() == CounterObj::dtor.load());
+    };
+
     struct Item { int producer; int seq; };
 
     "mpmc correctness"_test = [] {
@@ -145,6 +207,28 @@ suite<"chunk optimized michael & scott's queue"> _ = [] {
         expect(produced.load() == total);
         expect(consumed.load() == total);
     };
+
+    "more threads than one hazard record block"_test = [] {
+        mpmc_queue<int, 4> q;
+        constexpr int threads_count = 3 * static_cast<int>(hp::records_per_block);
+        constexpr int per_thread = 200;
+        std::latch all_started{threads_count};
+        std::atomic<long> sum{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&] {
+                // keep every thread alive so their records are held together
+                all_started.arrive_and_wait();
+                for (int i = 0; i < per_thread; ++i) {
+                    q.emplace_back(i);
+                    if (auto v = q.pop_front()) sum += *v;
+                }
+            });
+        }
+        for (auto& th: threads) th.join();
+        while (auto v = q.pop_front()) sum += *v;
+        expect(sum.load() == static_cast<long>(threads_count) * per_thread * (per_thread - 1) / 2);
+    };
 };
 
-}
\ No newline at end of file
+}
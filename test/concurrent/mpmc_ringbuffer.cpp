@@ -0,0 +1,123 @@
+#include <boost/ut.hpp>
+#include "concurrent/mpmc_ringbuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+
+struct CounterObj {
+    static std::atomic<int> ctor;
+    static std::atomic<int> dtor;
+    static std::atomic<int> move_ctor;
+    static std::atomic<int> copy_ctor;
+    int value;
+    explicit CounterObj(int v) : value(v) { ++ctor; }
+    CounterObj(const CounterObj& other) : value(other.value) { ++copy_ctor; }
+    CounterObj(CounterObj&& other) noexcept : value(other.value) { ++move_ctor; }
+    ~CounterObj() { ++dtor; }
+};
+
+std::atomic<int> CounterObj::ctor{0};
+std::atomic<int> CounterObj::dtor{0};
+std::atomic<int> CounterObj::move_ctor{0};
+std::atomic<int> CounterObj::copy_ctor{0};
+
+suite<"vyukov mpmc ringbuffer"> _ = [] {
+    "empty pop"_test = [] {
+        mpmc_ringbuffer<int, 8> q;
+        expect(!q.pop_front().has_value());
+    };
+
+    "capacity bound and wrap around"_test = [] {
+        mpmc_ringbuffer<int, 4> q;
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 4; ++i) {
+                expect(q.try_emplace_back(round * 4 + i));
+            }
+            expect(!q.try_emplace_back(-1)) << "ring should be full";
+            expect(q.size() == 4_u);
+            for (int i = 0; i < 4; ++i) {
+                auto value = q.pop_front();
+                expect(value.has_value());
+                expect(*value == round * 4 + i);
+            }
+            expect(!q.pop_front().has_value());
+        }
+    };
+
+    "object lifetime"_test = [] {
+        CounterObj::ctor.store(0);
+        CounterObj::dtor.store(0);
+        CounterObj::move_ctor.store(0);
+        CounterObj::copy_ctor.store(0);
+        {
+            mpmc_ringbuffer<CounterObj, 16> q;
+            for (int i = 0; i < 8; ++i) {
+                expect(q.try_emplace_back(i));
+            }
+            CounterObj obj(42);
+            q.push_back(obj);
+            q.push_back(CounterObj(99));
+            for (int i = 0; i < 4; ++i) {
+                expect(q.pop_front().has_value());
+            }
+            // the remaining 6 are destroyed with the ring
+        }
+        expect(CounterObj::ctor.load() + CounterObj::copy_ctor.load() + CounterObj::move_ctor.load() == CounterObj::dtor.load());
+    };
+
+    struct Item {
+        int producer;
+        int seq;
+    };
+
+    "blocking mpmc correctness"_test = [] {
+        constexpr int producers = 4;
+        constexpr int consumers = 4;
+        constexpr int per_producer = 20000;
+        constexpr int total = producers * per_producer;
+        constexpr int per_consumer = total / consumers;
+        mpmc_ringbuffer<Item, 64> q;
+        std::vector<std::atomic<bool>> seen(total);
+        std::atomic<bool> duplicate_free{true};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([p, &q] {
+                for (int i = 0; i < per_producer; ++i) {
+                    q.emplace_back(Item{p, i});
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                int last_seq[producers];
+                std::fill(std::begin(last_seq), std::end(last_seq), -1);
+                for (int i = 0; i < per_consumer; ++i) {
+                    auto v = q.pop_front_wait();
+                    if (seen[v.producer * per_producer + v.seq].exchange(true)) {
+                        duplicate_free.store(false);
+                    }
+                    // per producer order is kept for a single consumer
+                    if (v.seq <= last_seq[v.producer]) {
+                        duplicate_free.store(false);
+                    }
+                    last_seq[v.producer] = v.seq;
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        expect(duplicate_free.load());
+        expect(std::all_of(seen.begin(), seen.end(), [](auto& b) { return b.load(); }));
+        expect(!q.pop_front().has_value());
+    };
+};
+
+} // namespace
@@ -0,0 +1,93 @@
+#include <boost/ut.hpp>
+#include "concurrent/mpsc_lanes.h"
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+
+suite<"mpsc lanes"> _ = [] {
+    "single producer fifo"_test = [] {
+        mpsc_lanes<int, 8> q;
+        expect(!q.pop_front().has_value());
+        for (int i = 0; i < 8; ++i) {
+            expect(q.try_emplace_back(i));
+        }
+        expect(!q.try_emplace_back(8));
+        expect(q.size() == 8_u);
+        for (int i = 0; i < 8; ++i) {
+            expect(q.pop_front() == i);
+        }
+        expect(!q.pop_front().has_value());
+    };
+
+    "fifo per producer and nothing lost"_test = [] {
+        mpsc_lanes<std::pair<int, int>, 64> q;
+        constexpr int producers = 6;
+        constexpr int per_producer = 50000;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&q, p] {
+                for (int i = 0; i < per_producer; ++i) {
+                    q.emplace_back(p, i);
+                }
+            });
+        }
+        std::array<int, producers> next{};
+        int received = 0;
+        bool ordered = true;
+        std::array<std::pair<int, int>, 32> out{};
+        while (received < producers * per_producer) {
+            size_t n = q.pop_bulk(out.begin(), out.size());
+            for (size_t i = 0; i < n; ++i) {
+                auto [p, v] = out[i];
+                ordered &= next[p] == v;
+                next[p] = v + 1;
+            }
+            received += static_cast<int>(n);
+        }
+        for (auto& th : threads) th.join();
+        expect(ordered);
+        expect(!q.pop_front().has_value());
+    };
+
+    "lanes of exited threads are reused"_test = [] {
+        mpsc_lanes<int, 16> q;
+        for (int round = 0; round < 10; ++round) {
+            std::thread([&q, round] { q.emplace_back(round); }).join();
+        }
+        // every thread left before the next one started, so all of them
+        // pushed into the same lane and the order is kept across threads
+        for (int round = 0; round < 10; ++round) {
+            expect(q.pop_front() == round);
+        }
+        expect(!q.pop_front().has_value());
+    };
+
+    "producer outliving the queue"_test = [] {
+        std::atomic<bool> pushed{false};
+        std::atomic<bool> destroyed{false};
+        std::thread producer;
+        {
+            mpsc_lanes<std::vector<int>, 4> q;
+            producer = std::thread([&] {
+                q.emplace_back(std::vector<int>(100, 1));
+                pushed = true;
+                while (!destroyed.load()) {
+                    std::this_thread::yield();
+                }
+            });
+            while (!pushed.load()) {
+                std::this_thread::yield();
+            }
+        }
+        destroyed = true;
+        producer.join();
+        expect(true);
+    };
+};
+
+}
@@ -0,0 +1,119 @@
+#include <boost/ut.hpp>
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/object_pool.h"
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+
+struct tracked {
+    static inline std::atomic<int> alive{0};
+    explicit tracked(int v) : value(v) { ++alive; }
+    ~tracked() { --alive; }
+    int value;
+};
+
+suite<"object pool"> _ = [] {
+    "objects are reused"_test = [] {
+        object_pool<tracked, 4> pool{0, 1};
+        std::set<tracked*> first;
+        std::vector<tracked*> objs;
+        for (int i = 0; i < 20; ++i) {
+            objs.push_back(pool.allocate(i));
+            first.insert(objs.back());
+        }
+        expect(tracked::alive.load() == 20);
+        for (auto* obj : objs) pool.deallocate(obj);
+        expect(tracked::alive.load() == 0);
+
+        objs.clear();
+        for (int i = 0; i < 20; ++i) {
+            objs.push_back(pool.allocate(i));
+            expect(first.contains(objs.back()));
+            expect(objs.back()->value == i);
+        }
+        for (auto* obj : objs) pool.deallocate(obj);
+
+        auto s = pool.stats();
+        expect(s.allocations == 40_u);
+        expect(s.in_use == 0_u);
+        expect(s.heap_allocs == 20_u);
+        expect(s.owned == 20_u);
+        expect(s.depot_hits > 0_u);
+    };
+
+    "max_objects bounds the pool"_test = [] {
+        object_pool<tracked, 4> pool{8, 2};
+        std::vector<tracked*> objs;
+        for (int i = 0; i < 8; ++i) {
+            objs.push_back(pool.allocate(i));
+        }
+        expect(pool.allocate(8) == nullptr);
+        expect(pool.stats().exhausted == 1_u);
+        pool.deallocate(objs.back());
+        objs.pop_back();
+        objs.push_back(pool.allocate(8));
+        expect(objs.back() != nullptr);
+        for (auto* obj : objs) pool.deallocate(obj);
+    };
+
+    "trimming gives memory back"_test = [] {
+        object_pool<tracked, 4> pool{0, 1};
+        std::vector<tracked*> objs;
+        for (int i = 0; i < 64; ++i) {
+            objs.push_back(pool.allocate(i));
+        }
+        for (auto* obj : objs) pool.deallocate(obj);
+        expect(pool.stats().owned == 64_u);
+
+        // nothing was taken from the depot since it filled up
+        pool.trim_idle();
+        pool.trim_idle();
+        auto s = pool.stats();
+        expect(s.owned < 64_u);
+        expect(s.heap_frees == 64 - s.owned);
+
+        pool.trim();
+        expect(pool.stats().owned == 0_u);
+    };
+
+    "cross thread allocate and free"_test = [] {
+        object_pool<tracked> pool{};
+        mpmc_queue<tracked*> handoff;
+        constexpr int producers = 4;
+        constexpr int per_producer = 20000;
+        std::atomic<int> freed{0};
+        std::atomic<long> sum{0};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < per_producer; ++i) {
+                    handoff.emplace_back(pool.allocate(i));
+                }
+            });
+        }
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&] {
+                while (freed.load() < producers * per_producer) {
+                    if (auto obj = handoff.pop_front(); obj) {
+                        sum += (*obj)->value;
+                        pool.deallocate(*obj);
+                        ++freed;
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        auto s = pool.stats();
+        expect(sum.load() == producers * (static_cast<long>(per_producer) * (per_producer - 1) / 2));
+        expect(s.allocations == s.deallocations);
+        expect(s.in_use == 0_u);
+        expect(tracked::alive.load() == 0);
+    };
+};
+
+}
@@ -0,0 +1,105 @@
+#include <boost/ut.hpp>
+#include "concurrent/sharded_lru.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+// every entry costs one byte
+struct unit_size {
+    template<typename K, typename V>
+    size_t operator()(const K&, const V&) const { return 1; }
+};
+
+suite<"sharded lru"> _ = [] {
+    "hit, miss and overwrite"_test = [] {
+        sharded_lru<std::string, std::string> cache{};
+        expect(cache.get("a") == nullptr);
+        cache.put("a", "1");
+        cache.put("a", "2");
+        auto v = cache.get("a");
+        expect(v != nullptr && *v == "2");
+        expect(cache.erase("a"));
+        expect(!cache.erase("a"));
+
+        auto s = cache.stats();
+        expect(s.hits == 1_u);
+        expect(s.misses == 1_u);
+        expect(s.insertions == 2_u);
+        expect(s.entries == 0_u);
+        expect(s.bytes == 0_u);
+    };
+
+    "least recently used is evicted first"_test = [] {
+        sharded_lru<int, int, std::hash<int>, unit_size> cache{{.max_bytes = 3, .shards = 1}};
+        cache.put(1, 1);
+        cache.put(2, 2);
+        cache.put(3, 3);
+        expect(cache.get(1) != nullptr);
+        cache.put(4, 4);
+        expect(cache.get(2) == nullptr);
+        expect(cache.get(1) != nullptr);
+        expect(cache.get(3) != nullptr);
+        expect(cache.get(4) != nullptr);
+        auto s = cache.stats();
+        expect(s.evictions == 1_u);
+        expect(s.entries == 3_u);
+        expect(s.bytes == 3_u);
+    };
+
+    "values outlive eviction"_test = [] {
+        sharded_lru<int, std::string, std::hash<int>, unit_size> cache{{.max_bytes = 1, .shards = 1}};
+        cache.put(1, std::string(100, 'x'));
+        auto held = cache.get(1);
+        cache.put(2, "y");
+        expect(cache.get(1) == nullptr);
+        expect(held->size() == 100_u);
+    };
+
+    "entries expire"_test = [] {
+        sharded_lru<int, int> cache{{.default_ttl = 20ms}};
+        cache.put(1, 1);
+        cache.put(2, 2, 1h);
+        cache.put(3, 3);
+        expect(cache.get(1) != nullptr);
+        std::this_thread::sleep_for(30ms);
+        expect(cache.get(1) == nullptr);
+        expect(cache.get(2) != nullptr);
+        expect(cache.purge_expired() == 1_u);
+        auto s = cache.stats();
+        expect(s.expired == 2_u);
+        expect(s.entries == 1_u);
+    };
+
+    "concurrent readers and writers"_test = [] {
+        sharded_lru<int, int, std::hash<int>, unit_size> cache{{.max_bytes = 256, .shards = 8}};
+        std::atomic<size_t> wrong{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 20000; ++i) {
+                    int key = (i * 7 + t) % 1024;
+                    if (auto v = cache.get(key)) {
+                        if (*v != key * 2) ++wrong;
+                    } else {
+                        cache.put(key, key * 2);
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        auto s = cache.stats();
+        expect(wrong.load() == 0_u);
+        expect(s.hits + s.misses == 8 * 20000_u);
+        expect(s.bytes <= 256_u);
+        expect(s.entries == s.bytes);
+    };
+};
+
+}
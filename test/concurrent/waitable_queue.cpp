@@ -0,0 +1,138 @@
+#include <boost/ut.hpp>
+#include "concurrent/mpmc_queue.h"
+#include "concurrent/mpsc_queue.h"
+#include "concurrent/mpsc_ringbuffer.h"
+#include "concurrent/waitable_queue.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+namespace {
+
+using namespace boost::ut;
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+template<typename queue_t>
+void producers_and_sleeping_consumers(size_t consumers) {
+    waitable_queue<queue_t> q;
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<long> sum{0};
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (auto v = q.pop_front_wait([&] { return done.load(); })) {
+                sum += *v;
+                ++consumed;
+            }
+        });
+    }
+    std::vector<std::thread> pushers;
+    for (int p = 0; p < producers; ++p) {
+        pushers.emplace_back([&q] {
+            for (int i = 0; i < per_producer; ++i) {
+                if constexpr (std::is_same_v<decltype(q.emplace_back(i)), bool>) {
+                    while (!q.emplace_back(i)) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    q.emplace_back(i);
+                }
+                // give the consumers a chance to park
+                if (i % 1000 == 0) {
+                    std::this_thread::sleep_for(50us);
+                }
+            }
+        });
+    }
+    for (auto& th : pushers) th.join();
+    while (consumed.load() < producers * per_producer) {
+        std::this_thread::sleep_for(1ms);
+    }
+    done = true;
+    q.wake_all();
+    for (auto& th : threads) th.join();
+    expect(consumed.load() == producers * per_producer);
+    expect(sum.load() == producers * (static_cast<long>(per_producer) * (per_producer - 1) / 2));
+}
+
+suite<"waitable queue"> _ = [] {
+    "blocked pop is woken by a push"_test = [] {
+        waitable_queue<mpsc_queue<int>> q;
+        std::atomic<int> got{0};
+        std::thread consumer([&] {
+            auto v = q.pop_front_wait([] { return false; });
+            got = v.value_or(-1);
+        });
+        while (q.sleeping() == 0) {
+            std::this_thread::yield();
+        }
+        q.emplace_back(42);
+        consumer.join();
+        expect(got.load() == 42);
+        expect(q.sleeping() == 0_u);
+    };
+
+    "wake_all releases waiters once stopped"_test = [] {
+        waitable_queue<mpmc_queue<int>> q;
+        std::atomic<bool> stop{false};
+        std::atomic<int> empty{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                if (!q.pop_front_wait([&] { return stop.load(); })) {
+                    ++empty;
+                }
+            });
+        }
+        while (q.sleeping() < 4) {
+            std::this_thread::yield();
+        }
+        stop = true;
+        q.wake_all();
+        for (auto& th : threads) th.join();
+        expect(empty.load() == 4);
+    };
+
+    "timed pop gives up"_test = [] {
+        waitable_queue<mpsc_ringbuffer<int, 8>> q;
+        auto start = std::chrono::steady_clock::now();
+        expect(!q.pop_front_wait_for(20ms).has_value());
+        expect(std::chrono::steady_clock::now() - start >= 20ms);
+        expect(q.emplace_back(7));
+        expect(q.pop_front_wait_for(20ms) == 7);
+    };
+
+    "bulk push wakes bulk pop"_test = [] {
+        waitable_queue<mpsc_queue<int, 8>> q;
+        std::array<int, 16> out{};
+        std::atomic<size_t> n{0};
+        std::thread consumer([&] {
+            n = q.pop_bulk_wait(out.begin(), out.size(), [] { return false; });
+        });
+        while (q.sleeping() == 0) {
+            std::this_thread::yield();
+        }
+        std::array<int, 3> items{1, 2, 3};
+        q.emplace_back_bulk(items);
+        consumer.join();
+        expect(n.load() >= 1_u);
+        expect(out[0] == 1);
+    };
+
+    "mpsc queue with one sleeping consumer"_test = [] {
+        producers_and_sleeping_consumers<mpsc_queue<int>>(1);
+    };
+    "mpsc ringbuffer with one sleeping consumer"_test = [] {
+        producers_and_sleeping_consumers<mpsc_ringbuffer<int, 64>>(1);
+    };
+    "mpmc queue with sleeping consumers"_test = [] {
+        producers_and_sleeping_consumers<mpmc_queue<int>>(4);
+    };
+};
+
+}
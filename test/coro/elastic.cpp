@@ -0,0 +1,110 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <thread>
+#include "coro/simple_task.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+using coro::thread::detail::pool;
+
+// Short intervals so that the controller acts within a few milliseconds
+coro::thread::elastic_config config(size_t min_workers, size_t max_workers) {
+    coro::thread::elastic_config c{};
+    c.min_workers = min_workers;
+    c.max_workers = max_workers;
+    c.interval = 1ms;
+    c.grow_after = 2;
+    c.shrink_after = 5;
+    return c;
+}
+
+struct gate {
+    std::atomic<bool>   open{false};
+    std::atomic<size_t> finished{0};
+};
+
+struct onto {
+    pool& p;
+    bool await_ready() { return false; }
+    void await_suspend(std::coroutine_handle<> h) { this->p.submit(h); }
+    void await_resume() {}
+};
+
+// Keeps a worker of `p` busy until the gate opens, like a handler stuck in
+// foreign code
+coro::simple_task hold(pool& p, gate& g) {
+    co_await onto{p};
+    while (!g.open.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    g.finished.fetch_add(1, std::memory_order_release);
+}
+
+template<typename pred_t>
+bool eventually(pred_t pred) {
+    auto until = std::chrono::steady_clock::now() + 10s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= until) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+suite<"elastic coroutine pool"> _ = [] {
+    "config checks"_test = [] {
+        pool p;
+        expect(!p.init_elastic(config(0, 2)));
+        expect(!p.init_elastic(config(3, 2)));
+        expect(p.init_elastic(config(1, 1)));
+        expect(p.metrics().workers == 1_u);
+        expect(!p.init_elastic(config(1, 1)));
+    };
+
+    "grows to max_workers while work is stuck"_test = [] {
+        pool p;
+        expect(p.init_elastic(config(1, 3)));
+        gate g;
+        for (size_t i = 0; i < 4; ++i) {
+            hold(p, g);
+        }
+        expect(eventually([&] { return p.metrics().workers == 3; }));
+
+        // one handle stays queued, but the pool is at its maximum
+        std::this_thread::sleep_for(20ms);
+        expect(p.metrics().workers == 3_u);
+        expect(p.metrics().pending == 1_u);
+
+        g.open.store(true, std::memory_order_release);
+        expect(eventually([&] { return g.finished.load(std::memory_order_acquire) == 4; }));
+        expect(p.metrics().pending == 0_u);
+    };
+
+    "shrinks back to min_workers and reaps them"_test = [] {
+        pool p;
+        expect(p.init_elastic(config(1, 3)));
+        gate g;
+        for (size_t i = 0; i < 3; ++i) {
+            hold(p, g);
+        }
+        expect(eventually([&] { return p.metrics().workers == 3; }));
+        expect(p.threads() == 3_u);
+
+        g.open.store(true, std::memory_order_release);
+        expect(eventually([&] { return p.metrics().workers == 1; }));
+        expect(eventually([&] { return p.threads() == 1; }));
+
+        // and stays there
+        std::this_thread::sleep_for(20ms);
+        expect(p.metrics().workers == 1_u);
+        expect(g.finished.load() == 3_u);
+    };
+};
+
+}
@@ -0,0 +1,130 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <thread>
+#include "coro/offload.h"
+#include "coro/simple_task.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+
+struct outcome {
+    std::atomic<int>  value{0};
+    std::atomic<bool> inline_run{false};
+    std::atomic<bool> finished{false};
+};
+
+void wait_for(const std::atomic<bool>& flag) {
+    while (!flag.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void wait_for_completed(size_t expected) {
+    while (coro::thread::offload_stats().completed < expected) {
+        std::this_thread::yield();
+    }
+}
+
+// Offloads a job that waits for `gate`, and records whether it ran on the
+// thread that awaited it
+coro::simple_task run_offloaded(outcome& out, const std::atomic<bool>& gate) {
+    co_await coro::thread::dispatch_awaiter{};
+    auto caller = std::this_thread::get_id();
+    std::thread::id runner{};
+    int value = co_await coro::offload{[&] {
+        runner = std::this_thread::get_id();
+        wait_for(gate);
+        return 42;
+    }};
+    out.value.store(value, std::memory_order_relaxed);
+    out.inline_run.store(runner == caller, std::memory_order_relaxed);
+    out.finished.store(true, std::memory_order_release);
+}
+
+// Offloads a job that returns a reference to `target`
+coro::simple_task bump_offloaded(int& target, std::atomic<bool>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    int& ref = co_await coro::offload{[&]() -> int& { return target; }};
+    ++ref;
+    finished.store(true, std::memory_order_release);
+}
+
+// The offload pool is a process wide singleton that can be initialized
+// once, so the steps below run in order on a pool of one worker and one slot
+suite<"coroutine offload"> _ = [] {
+    coro::thread::init(4);
+    std::atomic<bool> open{true};
+
+    "inline before init"_test = [&] {
+        outcome out;
+        run_offloaded(out, open);
+        wait_for(out.finished);
+        expect(out.value == 42);
+        expect(out.inline_run.load());
+
+        auto stats = coro::thread::offload_stats();
+        expect(stats.rejected == 1_u);
+        expect(stats.submitted == 0_u);
+    };
+
+    "init once"_test = [] {
+        expect(coro::thread::init_offload(1, 1));
+        expect(!coro::thread::init_offload(1, 1));
+    };
+
+    "result off the calling worker"_test = [&] {
+        outcome out;
+        run_offloaded(out, open);
+        wait_for(out.finished);
+        expect(out.value == 42);
+        expect(!out.inline_run.load());
+
+        wait_for_completed(1);
+        auto stats = coro::thread::offload_stats();
+        expect(stats.submitted == 1_u);
+        expect(stats.completed == 1_u);
+        expect(stats.rejected == 1_u);
+        expect(stats.max_queue_depth == 1_u);
+    };
+
+    "inline when full"_test = [&] {
+        std::atomic<bool> gate{false};
+        outcome blocked;
+        run_offloaded(blocked, gate);
+        while (coro::thread::offload_stats().queue_depth == 0) {
+            std::this_thread::yield();
+        }
+
+        // the only slot is taken, so this one runs where it was awaited
+        outcome overflow;
+        run_offloaded(overflow, open);
+        wait_for(overflow.finished);
+        expect(overflow.value == 42);
+        expect(overflow.inline_run.load());
+        expect(!blocked.finished.load());
+
+        gate.store(true, std::memory_order_release);
+        wait_for(blocked.finished);
+        expect(blocked.value == 42);
+        expect(!blocked.inline_run.load());
+
+        wait_for_completed(2);
+        auto stats = coro::thread::offload_stats();
+        expect(stats.submitted == 2_u);
+        expect(stats.completed == 2_u);
+        expect(stats.rejected == 2_u);
+        expect(stats.queue_depth == 0_u);
+    };
+
+    "reference result"_test = [] {
+        int target = 1;
+        std::atomic<bool> finished{false};
+        bump_offloaded(target, finished);
+        wait_for(finished);
+        expect(target == 2);
+        wait_for_completed(3);
+    };
+};
+
+}
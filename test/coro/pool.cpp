@@ -0,0 +1,56 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include "coro/simple_task.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+
+#ifdef CORO_POOL_RING_CAPACITY
+constexpr size_t ring_capacity = CORO_POOL_RING_CAPACITY;
+#else
+constexpr size_t ring_capacity = 1024;
+#endif
+
+constexpr size_t fan_outs = 4;
+constexpr size_t per_fan_out = 4 * ring_capacity;
+
+void wait_for(const std::atomic<size_t>& counter, size_t expected) {
+    while (counter.load(std::memory_order_acquire) < expected) {
+        std::this_thread::yield();
+    }
+}
+
+coro::simple_task leaf(std::atomic<size_t>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+// Submits far more than the ring holds from a worker, without giving the
+// worker back to the pool in between
+coro::simple_task fan_out(std::atomic<size_t>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    for (size_t i = 0; i < per_fan_out; ++i) {
+        leaf(finished);
+    }
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+suite<"coroutine pool"> _ = [] {
+    coro::thread::init(4);
+
+    // with the bounded ring, workers blocking on a full ring would leave
+    // nobody to drain it
+    "ring filled from inside the pool"_test = [] {
+        std::atomic<size_t> finished{0};
+        for (size_t i = 0; i < fan_outs; ++i) {
+            fan_out(finished);
+        }
+        wait_for(finished, fan_outs * (per_fan_out + 1));
+        expect(finished.load() == fan_outs * (per_fan_out + 1));
+    };
+};
+
+}
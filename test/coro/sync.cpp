@@ -0,0 +1,133 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "coro/channel.h"
+#include "coro/simple_task.h"
+#include "coro/sync.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+
+void wait_for(std::atomic<int>& counter, int expected) {
+    while (counter.load(std::memory_order_acquire) < expected) {
+        std::this_thread::yield();
+    }
+}
+
+coro::simple_task add_under_lock(coro::async_mutex& m, int& value, int times, std::atomic<int>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    for (int i = 0; i < times; ++i) {
+        auto guard = co_await m.scoped_lock();
+        ++value;
+    }
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+coro::simple_task limited(coro::async_semaphore& sem, std::atomic<int>& inside, std::atomic<int>& peak, std::atomic<int>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    co_await sem.acquire();
+    int now = inside.fetch_add(1) + 1;
+    int p = peak.load();
+    while (now > p && !peak.compare_exchange_weak(p, now)) {}
+    std::this_thread::yield();
+    inside.fetch_sub(1);
+    sem.release();
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+coro::simple_task wait_event(coro::async_event& e, std::atomic<int>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    co_await e;
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+coro::simple_task produce(coro::channel<int>& ch, int from, int count, std::atomic<int>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    for (int i = from; i < from + count; ++i) {
+        co_await ch.send(i);
+    }
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+coro::simple_task consume(coro::channel<int>& ch, std::atomic<long>& sum, std::atomic<int>& finished) {
+    co_await coro::thread::dispatch_awaiter{};
+    while (auto v = co_await ch.recv()) {
+        sum.fetch_add(*v, std::memory_order_relaxed);
+    }
+    finished.fetch_add(1, std::memory_order_release);
+}
+
+suite<"coroutine synchronization"> _ = [] {
+    coro::thread::init(4);
+
+    "async mutex"_test = [] {
+        coro::async_mutex m;
+        int value = 0;
+        std::atomic<int> finished{0};
+        for (int i = 0; i < 8; ++i) {
+            add_under_lock(m, value, 1000, finished);
+        }
+        wait_for(finished, 8);
+        expect(value == 8000);
+        expect(m.try_lock());
+        m.unlock();
+    };
+
+    "async semaphore"_test = [] {
+        coro::async_semaphore sem{2};
+        std::atomic<int> inside{0}, peak{0}, finished{0};
+        for (int i = 0; i < 64; ++i) {
+            limited(sem, inside, peak, finished);
+        }
+        wait_for(finished, 64);
+        expect(peak.load() <= 2);
+        expect(sem.available() == 2_u);
+    };
+
+    "async event"_test = [] {
+        coro::async_event e;
+        std::atomic<int> finished{0};
+        for (int i = 0; i < 16; ++i) {
+            wait_event(e, finished);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        expect(finished.load() == 0);
+        e.set();
+        wait_for(finished, 16);
+        expect(e.is_set());
+    };
+
+    "bounded channel"_test = [] {
+        for (size_t capacity : {0uz, 1uz, 16uz}) {
+            coro::channel<int> ch{capacity};
+            std::atomic<int> producers{0}, consumers{0};
+            std::atomic<long> sum{0};
+            for (int c = 0; c < 3; ++c) {
+                consume(ch, sum, consumers);
+            }
+            for (int p = 0; p < 4; ++p) {
+                produce(ch, p * 1000, 1000, producers);
+            }
+            wait_for(producers, 4);
+            ch.close();
+            wait_for(consumers, 3);
+            expect(sum.load() == 3999L * 4000 / 2);
+        }
+    };
+
+    "channel try variants"_test = [] {
+        coro::channel<int> ch{1};
+        int v = 1;
+        expect(ch.try_send(v));
+        v = 2;
+        expect(!ch.try_send(v));
+        expect(ch.try_recv() == std::optional<int>{1});
+        expect(!ch.try_recv().has_value());
+        ch.close();
+        expect(!ch.try_send(v));
+    };
+};
+
+}
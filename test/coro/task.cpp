@@ -0,0 +1,78 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "coro/awaitable_task.h"
+#include "coro/lazy_task.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+
+coro::lazy_task<int> add_one(int i) {
+    co_await coro::thread::dispatch_awaiter{};
+    co_return i + 1;
+}
+
+coro::lazy_task<std::unique_ptr<int>> boxed(int i) {
+    co_await coro::thread::dispatch_awaiter{};
+    co_return std::make_unique<int>(i);
+}
+
+coro::awaitable_task<int> triple(int i) {
+    co_await coro::thread::dispatch_awaiter{};
+    co_return i * 3;
+}
+
+// Publishes `i` only after a hop to a worker, and sometimes a nap there,
+// so that the owner is left waiting
+coro::lazy_task<int> publish(std::atomic<int>& out, int i) {
+    co_await coro::thread::dispatch_awaiter{};
+    if (i % 64 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds{200});
+    }
+    out.store(i, std::memory_order_relaxed);
+    co_return i;
+}
+
+coro::lazy_task<int> chain(int i) {
+    int a = co_await add_one(i);
+    auto b = co_await boxed(i);
+    int c = co_await triple(i);
+    co_return a + *b + c;
+}
+
+suite<"coroutine tasks"> _ = [] {
+    coro::thread::init(4);
+
+    "lazy_task sync_wait"_test = [] {
+        auto t = add_one(41);
+        expect(coro::sync_wait(t) == 42);
+        expect(t.done());
+    };
+
+    "awaitable_task sync_wait"_test = [] {
+        auto t = triple(7);
+        expect(coro::sync_wait(t) == 21);
+    };
+
+    "continuation chain"_test = [] {
+        for (int i = 0; i < 1000; ++i) {
+            auto t = chain(i);
+            expect(coro::sync_wait(t) == (i + 1) + i + i * 3);
+        }
+    };
+
+    "destructor joins"_test = [] {
+        std::atomic<int> seen{-1};
+        for (int i = 0; i < 1000; ++i) {
+            {
+                auto t = publish(seen, i);
+            }
+            expect(seen.load(std::memory_order_relaxed) == i) << i;
+        }
+    };
+};
+
+}
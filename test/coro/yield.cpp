@@ -0,0 +1,96 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "coro/simple_task.h"
+#include "coro/thread.h"
+namespace {
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+struct yield_count {
+    std::atomic<size_t> yields{0};
+    std::atomic<bool>   finished{false};
+};
+
+void wait_for(const std::atomic<bool>& flag) {
+    while (!flag.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void wait_for_slices(size_t expected) {
+    while (coro::thread::metrics().slices < expected) {
+        std::this_thread::yield();
+    }
+}
+
+// Calls maybe_yield `ops` times, or until `duration` has passed if given,
+// and counts the calls that actually rescheduled
+coro::simple_task spin(yield_count& out, size_t ops, coro::thread::clock::duration duration = {}) {
+    co_await coro::thread::dispatch_awaiter{};
+    auto until = coro::thread::clock::now() + duration;
+    size_t yields = 0;
+    for (size_t i = 0; i < ops || coro::thread::clock::now() < until; ++i) {
+        auto before = coro::thread::metrics().yields;
+        co_await coro::maybe_yield{};
+        yields += coro::thread::metrics().yields != before;
+    }
+    out.yields.store(yields, std::memory_order_relaxed);
+    out.finished.store(true, std::memory_order_release);
+}
+
+suite<"coroutine yield budget"> _ = [] {
+    coro::thread::init(4);
+
+    "outside a worker"_test = [] {
+        coro::thread::set_budget(1h, 1);
+        expect(coro::maybe_yield{}.await_ready());
+    };
+
+    "within budget"_test = [] {
+        coro::thread::set_budget(1h, 1'000'000);
+        auto before = coro::thread::metrics();
+        yield_count out;
+        spin(out, 1000);
+        wait_for(out.finished);
+        expect(out.yields == 0_u);
+        expect(coro::thread::metrics().yields == before.yields);
+    };
+
+    "op budget used up"_test = [] {
+        coro::thread::set_budget(1h, 100);
+        auto before = coro::thread::metrics();
+        yield_count out;
+        spin(out, 1000);
+        wait_for(out.finished);
+        // every 100th call starts a new slice, plus the first dispatch
+        expect(out.yields == 10_u);
+        expect(coro::thread::metrics().yields - before.yields == 10_u);
+        wait_for_slices(before.slices + 11);
+    };
+
+    "time slice used up"_test = [] {
+        coro::thread::set_budget(1ms, 0);
+        auto before = coro::thread::metrics();
+        yield_count out;
+        spin(out, 0, 20ms);
+        wait_for(out.finished);
+        expect(out.yields >= 1_u);
+        expect(coro::thread::metrics().yields - before.yields == out.yields.load());
+        wait_for_slices(before.slices + 1 + out.yields);
+    };
+
+    "no op budget"_test = [] {
+        coro::thread::set_budget(1h, 0);
+        yield_count out;
+        spin(out, 100'000);
+        wait_for(out.finished);
+        expect(out.yields == 0_u);
+    };
+
+    coro::thread::set_budget(2ms, 4096);
+};
+
+}
@@ -0,0 +1,67 @@
+#include <boost/ut.hpp>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "http/http.h"
+
+namespace {
+using namespace boost::ut;
+
+suite<"http decoding"> _ = []{
+    "pct decode without escapes is the input"_test = [] {
+        std::string buffer;
+        std::error_code ec;
+        std::string_view path = "/static/index.html";
+        auto decoded = http::pct_decode(path, buffer, ec);
+        expect(!ec);
+        expect(decoded.data() == path.data() && decoded.size() == path.size());
+        expect(buffer.capacity() <= std::string{}.capacity());
+    };
+
+    "pct decode"_test = [] {
+        std::string buffer;
+        std::error_code ec;
+        expect(http::pct_decode("/a%20b/%E4%BD%A0", buffer, ec) == "/a b/\xe4\xbd\xa0");
+        expect(!ec);
+        // '+' is only a space in form encoding
+        expect(http::pct_decode("a+b%2B", buffer, ec) == "a+b+");
+        expect(http::form_decode("a+b%2B", buffer, ec) == "a b+");
+        // long runs between escapes go through the vector scan
+        auto long_run = std::string(100, 'x');
+        expect(http::pct_decode(long_run + "%41" + long_run, buffer, ec) == long_run + "A" + long_run);
+        expect(!ec);
+    };
+
+    "pct decode rejects malformed escapes"_test = [] {
+        for (std::string_view bad : {"%", "%4", "a%zz", "%4g", "abc%"}) {
+            std::string buffer;
+            std::error_code ec;
+            http::pct_decode(bad, buffer, ec);
+            expect(ec == std::errc::invalid_argument) << bad;
+        }
+    };
+
+    "query params"_test = [] {
+        http::query_params params{"q=hello+world&&flag&lang=zh%2Dcn&caf%C3%A9=1&q=second"};
+
+        std::vector<std::pair<std::string_view, std::string_view>> raw;
+        for (const auto& [key, value] : params) {
+            raw.emplace_back(key, value);
+        }
+        expect(raw.size() == 5_u);
+        expect(raw[1].first == "flag" && raw[1].second.empty());
+
+        std::string buffer;
+        expect(params.get("q", buffer) == "hello world");
+        expect(params.get("lang", buffer) == "zh-cn");
+        expect(params.get("café", buffer) == "1");
+        expect(params.raw("q") == "hello+world");
+        expect(params.contains("flag"));
+        expect(!params.contains("missing"));
+        expect(!params.get("missing", buffer).has_value());
+
+        expect(http::query_params{""}.begin() == http::query_params{""}.end());
+    };
+};
+}
@@ -0,0 +1,127 @@
+#include <boost/ut.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "http/multipart.h"
+
+namespace {
+using namespace boost::ut;
+using namespace http;
+
+struct collected {
+    std::string name;
+    std::string filename;
+    std::string content_type;
+    std::string body;
+};
+
+// Feeds `raw` in pieces of `piece` bytes, each piece in a buffer of its own
+// that is overwritten by the next one, like socket reads
+std::vector<collected> parse(std::string_view boundary, std::string_view raw, size_t piece, bool& ok) {
+    multipart::parser parser{boundary};
+    std::vector<collected> parts;
+    std::string buffer;
+    ok = false;
+    for (size_t i = 0; i <= raw.size(); i += piece) {
+        buffer.assign(raw.substr(std::min(i, raw.size()), piece));
+        std::string_view input = buffer;
+        while (true) {
+            auto [kind, data] = parser.next(input);
+            if (kind == multipart::parser::need_more) {
+                break;
+            } else if (kind == multipart::parser::part) {
+                const auto& part = parser.current();
+                parts.push_back({
+                    std::string{part.name},
+                    std::string{part.filename.value_or("")},
+                    std::string{part.header["content-type"]},
+                    {}
+                });
+            } else if (kind == multipart::parser::data) {
+                parts.back().body += data;
+            } else if (kind == multipart::parser::done) {
+                ok = true;
+                return parts;
+            } else if (kind == multipart::parser::failed) {
+                return parts;
+            }
+        }
+    }
+    return parts;
+}
+
+suite<"http multipart"> _ = []{
+    "boundary"_test = [] {
+        expect(multipart::boundary("multipart/form-data; boundary=abc123") == "abc123");
+        expect(multipart::boundary("Multipart/Form-Data; charset=utf-8; Boundary=\"a b:c\"") == "a b:c");
+        expect(!multipart::boundary("text/plain; boundary=abc").has_value());
+        expect(!multipart::boundary("multipart/form-data").has_value());
+        expect(!multipart::boundary("multipart/form-data; boundary=\"bad\r\n\"").has_value());
+        expect(!multipart::boundary("multipart/form-data; boundary=" + std::string(71, 'a')).has_value());
+    };
+
+    "parts across any split"_test = [] {
+        // the file holds CRs and a near boundary, neither may end it early
+        std::string file = "line one\r\nline two\r\n--XyZ\r\n-\r\r\n--XyZzx almost";
+        for (int i = 0; i < 64; ++i) {
+            file += static_cast<char>(i * 7);
+        }
+        std::string raw =
+            "preamble to be ignored\r\n"
+            "--XyZzy\r\n"
+            "Content-Disposition: form-data; name=\"title\"\r\n"
+            "\r\n"
+            "Hello\r\n"
+            "--XyZzy  \r\n"
+            "content-disposition: form-data; name=\"upload\"; filename=\"a;b.bin\"\r\n"
+            "Content-Type: application/octet-stream\r\n"
+            "\r\n" + file + "\r\n"
+            "--XyZzy\r\n"
+            "Content-Disposition: form-data; name=\"empty\"\r\n"
+            "\r\n"
+            "\r\n"
+            "--XyZzy--\r\n"
+            "epilogue";
+
+        for (size_t piece = 1; piece <= raw.size(); piece = piece < 16 ? piece + 1 : piece * 2) {
+            bool ok = false;
+            auto parts = parse("XyZzy", raw, piece, ok);
+            expect(ok) << piece;
+            expect(parts.size() == 3_u);
+            if (parts.size() != 3) {
+                continue;
+            }
+            expect(parts[0].name == "title" && parts[0].body == "Hello" && parts[0].filename.empty());
+            expect(parts[1].name == "upload" && parts[1].filename == "a;b.bin");
+            expect(parts[1].content_type == "application/octet-stream");
+            expect(parts[1].body == file) << piece;
+            expect(parts[2].name == "empty" && parts[2].body.empty());
+        }
+    };
+
+    "body starting with the boundary"_test = [] {
+        bool ok = false;
+        auto parts = parse("b", "--b\r\n\r\nx\r\n--b--", 3, ok);
+        expect(ok);
+        expect(parts.size() == 1_u && parts[0].body == "x");
+    };
+
+    "malformed"_test = [] {
+        for (std::string_view raw : {
+            // garbage after the boundary
+            "--b junk\r\n\r\nx\r\n--b--",
+            // header line without a colon
+            "--b\r\nno colon here\r\n\r\nx\r\n--b--",
+        }) {
+            bool ok = true;
+            parse("b", raw, raw.size(), ok);
+            expect(!ok) << raw;
+        }
+
+        multipart::parser parser{"b", {.max_part_header = 16}};
+        std::string_view input = "--b\r\nX-Long: 0123456789abcdef\r\n\r\n";
+        auto kind = parser.next(input).kind;
+        expect(kind == multipart::parser::failed);
+    };
+};
+}
@@ -1,5 +1,8 @@
 #include <boost/ut.hpp>
+#include <algorithm>
+#include <format>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -197,6 +200,408 @@ suite<"request parser"> _ = []{
         expect(request2.body.empty());
     };
 
+    "split across reused buffer"_test = [] {
+        std::string_view raw_request = "POST /split?a=b HTTP/1.1\r\nHost: example.com\r\nContent-Length: 11\r\n\r\nHello World";
+
+        // 1 byte pieces also split every CRLF
+        for (size_t piece : {1uz, 7uz}) {
+            auto parser = request::parser{};
+            std::string buffer;
+            for (size_t i = 0; i < raw_request.size(); i += piece) {
+                // the same buffer is overwritten for every feed, like a socket read
+                buffer.assign(raw_request.substr(i, piece));
+                parser.feed(buffer);
+            }
+            buffer.assign(buffer.size(), '#');
+
+            expect(!parser.empty());
+            auto request_opt = parser.pop_front();
+            expect(request_opt.has_value());
+            expect(parser.empty());
+
+            request::msg& request = request_opt.value();
+            auto origin = std::get_if<request::origin_form>(&request.line.target);
+            expect(
+                origin != nullptr
+                && origin->path == "/split"
+                && origin->query == "a=b"
+                && request.line.version == "HTTP/1.1"
+            );
+            expect(request.header.size() == 2);
+            expect(request.header["Host"] == "example.com");
+            expect(request.header["Content-Length"] == "11");
+            expect(request.body == "Hello World");
+        }
+    };
+
+    "reset drops the partial request"_test = [] {
+        auto parser = request::parser{};
+        parser.feed("GET /first HTTP/1.1\r\nHost: exa");
+        expect(parser.empty());
+
+        parser.reset();
+        parser.feed("GET /second HTTP/1.1\r\nHost: example.org\r\n\r\n");
+
+        expect(!parser.empty());
+        auto request_opt = parser.pop_front();
+        expect(request_opt.has_value());
+        expect(parser.empty());
+        expect(std::get<request::origin_form>(request_opt->line.target).path == "/second");
+        expect(request_opt->header.size() == 1);
+        expect(request_opt->header["Host"] == "example.org");
+    };
+
+    "parser is reused across requests"_test = [] {
+        auto parser = request::parser{};
+        for (size_t i = 0; i < 3; ++i) {
+            // the second request starts in the same feed as the first one ends
+            parser.feed("GET /a HTTP/1.1\r\n\r\nGET /b HT");
+            parser.feed("TP/1.1\r\n\r\n");
+            auto a = parser.pop_front();
+            auto b = parser.pop_front();
+            expect(parser.empty());
+            expect(a.has_value() && std::get<request::origin_form>(a->line.target).path == "/a");
+            expect(b.has_value() && std::get<request::origin_form>(b->line.target).path == "/b");
+            expect(b.has_value() && b->line.version == "HTTP/1.1");
+        }
+    };
+
+    "many headers"_test = [] {
+        std::string raw_request = "GET / HTTP/1.1\r\n";
+        for (size_t i = 0; i < request::header::inline_capacity + 8; ++i) {
+            raw_request += std::format("X-Field-{}: {}\r\n", i, i);
+        }
+        raw_request += "\r\n";
+
+        auto parser = request::parser{};
+        parser.feed(raw_request);
+
+        auto request_opt = parser.pop_front();
+        expect(request_opt.has_value());
+
+        auto& header = request_opt.value().header;
+        expect(header.size() == request::header::inline_capacity + 8);
+        expect(header["X-Field-0"] == "0");
+        expect(header["X-Field-31"] == "31");
+        expect(!header.contains("X-Field-32"));
+    };
+
+    "field names ignore case"_test = [] {
+        std::string_view raw_request =
+            "POST /submit HTTP/1.1\r\n"
+            "host: example.com\r\n"
+            "X-Custom: a\r\n"
+            "CONTENT-LENGTH: 5\r\n"
+            "x-custom: b\r\n"
+            "connection: close\r\n"
+            "\r\n"
+            "Hello";
+
+        auto parser = request::parser{};
+        parser.feed(raw_request);
+        auto request_opt = parser.pop_front();
+        expect(request_opt.has_value());
+        expect(request_opt->body == "Hello");
+
+        auto& header = request_opt->header;
+        expect(header[request::known_field::host] == "example.com");
+        expect(header["Host"] == "example.com");
+        expect(header["Content-Length"] == "5");
+        expect(header[request::known_field::connection] == "close");
+        expect(header["X-CUSTOM"] == "a");
+        expect(!header.contains(request::known_field::range));
+        expect(!header.contains("Range"));
+    };
+
+    "known fields past the inline capacity"_test = [] {
+        request::header header;
+        for (size_t i = 0; i < request::header::inline_capacity; ++i) {
+            header.emplace("X-Filler", "x");
+        }
+        header.emplace("Range", "bytes=0-99");
+        header.emplace("range", "bytes=100-199");
+        expect(header[request::known_field::range] == "bytes=0-99");
+        header.clear();
+        expect(!header.contains(request::known_field::range));
+    };
+
+    "chunked body"_test = [] {
+        std::string_view raw_request =
+            "POST /upload HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "Transfer-Encoding: gzip, Chunked\r\n"
+            "\r\n"
+            "5;name=value\r\nHello\r\n"
+            "6 ; ext\r\n World\r\n"
+            "0\r\n"
+            "Checksum: abc\r\n"
+            "\r\n"
+            "GET /next HTTP/1.1\r\n\r\n";
+
+        for (size_t piece : {1uz, 5uz, raw_request.size()}) {
+            auto parser = request::parser{};
+            std::string buffer;
+            for (size_t i = 0; i < raw_request.size(); i += piece) {
+                buffer.assign(raw_request.substr(i, piece));
+                parser.feed(buffer);
+            }
+
+            auto request_opt = parser.pop_front();
+            expect(request_opt.has_value());
+            expect(request_opt->body == "Hello World");
+            expect(request_opt->trailer.size() == 1);
+            expect(request_opt->trailer["Checksum"] == "abc");
+            expect(request_opt->header["Host"] == "example.com");
+
+            auto next = parser.pop_front();
+            expect(next.has_value() && std::get<request::origin_form>(next->line.target).path == "/next");
+            expect(parser.empty());
+        }
+    };
+
+    "streamed body"_test = [] {
+        std::vector<std::pair<std::string_view, std::string_view>> cases = {
+            {
+                "POST /a HTTP/1.1\r\nContent-Length: 11\r\n\r\n"
+                "Hello World"
+                "GET /next HTTP/1.1\r\n\r\n",
+                "Hello World"
+            },
+            {
+                "POST /b HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                "5;ext\r\nHello\r\n6\r\n World\r\n0\r\nChecksum: abc\r\n\r\n"
+                "GET /next HTTP/1.1\r\n\r\n",
+                "Hello World"
+            },
+        };
+        // far smaller than the bodies, streaming does not buffer them
+        request::limits limit{};
+        limit.max_body_size = 4;
+
+        for (auto [raw_request, expected] : cases) {
+            for (size_t piece : {1uz, 3uz, raw_request.size()}) {
+                auto parser = request::parser{limit, request::body_mode::stream};
+                std::vector<std::string> buffers;
+                std::string body;
+                std::optional<request::msg> head;
+                for (size_t i = 0; i < raw_request.size(); i += piece) {
+                    // every read gets its own buffer, streamed pieces point into it
+                    std::string_view data = buffers.emplace_back(raw_request.substr(i, piece));
+                    while (!data.empty()) {
+                        if (parser.reading_body()) {
+                            body += parser.read_body(data);
+                        } else {
+                            data.remove_prefix(parser.feed(data));
+                            if (!head && !parser.empty()) {
+                                head = std::move(parser.pop_front().value());
+                            }
+                        }
+                    }
+                }
+
+                expect(head.has_value() && head->body_follows);
+                expect(head->body.empty());
+                expect(body == expected) << body;
+                expect(!parser.reading_body() && !parser.body_failed());
+
+                auto next = parser.pop_front();
+                expect(next.has_value() && !next->body_follows);
+                expect(std::get<request::origin_form>(next->line.target).path == "/next");
+                expect(parser.empty());
+            }
+        }
+    };
+
+    "streamed body failure"_test = [] {
+        auto parser = request::parser{{}, request::body_mode::stream};
+        std::string_view data = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabc\r\n";
+        data.remove_prefix(parser.feed(data));
+        expect(parser.pop_front()->body_follows);
+        expect(parser.read_body(data) == "ab");
+        expect(parser.read_body(data).empty());
+        expect(parser.body_failed() && !parser.reading_body());
+        expect(!parser.pop_front().has_value());
+    };
+
+    "streamed body trailers"_test = [] {
+        std::string_view raw_request =
+            "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+            "5\r\nHello\r\n0\r\nChecksum: abc\r\nExpires: never\r\n\r\n"
+            "POST /b HTTP/1.1\r\nContent-Length: 2\r\n\r\nhi";
+
+        for (size_t piece : {1uz, 3uz, raw_request.size()}) {
+            auto parser = request::parser{{}, request::body_mode::stream};
+            std::string buffer;
+            std::vector<request::msg> heads;
+            std::vector<std::string> trailers;
+            for (size_t i = 0; i < raw_request.size(); i += piece) {
+                // reused for every read, the trailers may not point into it
+                buffer.assign(raw_request.substr(i, piece));
+                std::string_view data = buffer;
+                while (!data.empty()) {
+                    if (parser.reading_body()) {
+                        parser.read_body(data);
+                        if (!parser.reading_body() && heads.size() == 1) {
+                            for (const auto& [name, value] : parser.trailers()) {
+                                trailers.push_back(std::format("{}={}", name, value));
+                            }
+                        }
+                    } else {
+                        data.remove_prefix(parser.feed(data));
+                        while (!parser.empty()) {
+                            heads.push_back(std::move(parser.pop_front().value()));
+                        }
+                    }
+                }
+                if (!parser.reading_body() && heads.size() == 1) {
+                    expect(parser.trailers()["Checksum"] == "abc");
+                    expect(parser.trailers()["Expires"] == "never");
+                }
+            }
+
+            expect(heads.size() == 2_u);
+            expect(trailers == std::vector<std::string>{"Checksum=abc", "Expires=never"});
+            // the next streamed body starts over
+            expect(parser.trailers().empty());
+        }
+    };
+
+    "streamed chunk framing is not kept"_test = [] {
+        std::string raw_request = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+        std::string expected;
+        for (size_t i = 0; i < 1000; ++i) {
+            char c = static_cast<char>('a' + i % 26);
+            raw_request += std::format("1;n={}\r\n{}\r\n", i, c);
+            expected += c;
+        }
+        raw_request += "0\r\n\r\n";
+
+        for (size_t piece : {1uz, 3uz}) {
+            auto parser = request::parser{{}, request::body_mode::stream};
+            std::string buffer;
+            std::string body;
+            size_t held = 0;
+            for (size_t i = 0; i < raw_request.size(); i += piece) {
+                buffer.assign(raw_request.substr(i, piece));
+                std::string_view data = buffer;
+                while (!data.empty()) {
+                    if (parser.reading_body()) {
+                        body += parser.read_body(data);
+                        held = std::max(held, parser.held_blocks());
+                    } else {
+                        data.remove_prefix(parser.feed(data));
+                    }
+                }
+            }
+            expect(parser.pop_front()->body_follows);
+            expect(body == expected);
+            expect(!parser.reading_body() && !parser.body_failed());
+            expect(held == 0_u) << piece;
+        }
+    };
+
+    "repeated framing fields"_test = [] {
+        std::string_view raw_request =
+            "POST /a HTTP/1.1\r\nContent-Length: 3\r\nContent-Length: 3\r\n\r\nabc"
+            "POST /b HTTP/1.1\r\nTransfer-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nxyz\r\n0\r\n\r\n";
+        auto parser = request::parser{};
+        parser.feed(raw_request);
+
+        auto first = parser.pop_front();
+        expect(first.has_value() && first->body == "abc");
+        auto second = parser.pop_front();
+        expect(second.has_value() && second->body == "xyz");
+    };
+
+    "chunked limits"_test = [] {
+        request::limits limit{};
+        limit.max_body_size = 8;
+        limit.max_streamed_body = 8;
+        limit.max_chunk_line = 16;
+        limit.max_trailer_size = 16;
+
+        std::vector<std::pair<std::string_view, request::error>> rejected = {
+            // body over max_body_size
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nHello\r\n5\r\nWorld\r\n0\r\n\r\n", request::error::body_too_large},
+            {"POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\nHello World", request::error::body_too_large},
+            // chunk size line over max_chunk_line
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1;aaaaaaaaaaaaaaaaaaaaaaaa", request::error::malformed},
+            // trailers over max_trailer_size
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n0\r\nA: 1\r\nLong-Trailer: 12345\r\n\r\n", request::error::header_too_large},
+            // size overflows
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1ffffffffffffffff\r\n", request::error::malformed},
+            // not hex
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n", request::error::malformed},
+            // no CRLF after the data
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabc\r\n0\r\n\r\n", request::error::malformed},
+            // both framings
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 3\r\n\r\n0\r\n\r\n", request::error::malformed},
+            // chunked is not the last coding
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n0\r\n\r\n", request::error::malformed},
+            // nor in the last Transfer-Encoding field
+            {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding: gzip\r\n\r\n0\r\n\r\n", request::error::malformed},
+            // Content-Length fields that disagree
+            {"POST / HTTP/1.1\r\nContent-Length: 3\r\ncontent-length: 4\r\n\r\nabcd", request::error::malformed},
+        };
+
+        for (auto mode : {request::body_mode::buffer, request::body_mode::stream}) {
+            for (auto [raw_request, reason] : rejected) {
+                auto parser = request::parser{limit, mode};
+                std::string_view data = raw_request;
+                while (!data.empty() && (parser.empty() || parser.reading_body())) {
+                    if (parser.reading_body()) {
+                        parser.read_body(data);
+                    } else {
+                        data.remove_prefix(parser.feed(data));
+                    }
+                }
+                // a streamed request is handed out ahead of its failing body
+                if (!parser.empty() && parser.body_failed()) {
+                    expect(parser.pop_front().has_value());
+                }
+                expect(!parser.empty());
+                auto result = parser.pop_front();
+                expect(!result.has_value() && result.error() == reason) << raw_request;
+            }
+        }
+    };
+
+    "head limits"_test = [] {
+        request::limits limit{};
+        limit.max_request_line = 32;
+        limit.max_header_size = 32;
+        limit.max_header_count = 2;
+
+        std::vector<std::pair<std::string, request::error>> rejected = {
+            {"GET /" + std::string(40, 'a') + " HTTP/1.1\r\n\r\n", request::error::request_line_too_long},
+            // no CRLF in sight, rejected before the line ends
+            {"GET /" + std::string(40, 'a'), request::error::request_line_too_long},
+            {"GET / HTTP/1.1\r\nX-Long: " + std::string(40, 'a'), request::error::header_too_large},
+            {"GET / HTTP/1.1\r\nA: 1234567890\r\nB: 1234567890\r\nC: 12\r\n\r\n", request::error::header_too_large},
+            {"GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n", request::error::header_too_large},
+        };
+
+        for (const auto& [raw_request, reason] : rejected) {
+            for (size_t piece : {1uz, raw_request.size()}) {
+                auto parser = request::parser{limit};
+                for (size_t i = 0; i < raw_request.size() && parser.empty(); i += piece) {
+                    parser.feed(std::string_view{raw_request}.substr(i, piece));
+                }
+                expect(!parser.empty());
+                auto result = parser.pop_front();
+                expect(!result.has_value() && result.error() == reason) << raw_request;
+            }
+        }
+
+        auto parser = request::parser{limit};
+        std::string at_limits = "GET /" + std::string(18, 'a') + " HTTP/1.1\r\nA: 1\r\nB: 2\r\n\r\n";
+        parser.feed(at_limits);
+        expect(!parser.reading_head());
+        expect(parser.pop_front().has_value());
+        parser.feed("GET / HTTP/1.1\r\nA:");
+        expect(parser.reading_head());
+    };
+
     "malformed request"_test = [] {
 
         std::vector<std::string_view> malformed_requests = {
@@ -214,6 +619,8 @@ suite<"request parser"> _ = []{
             "GET /test HTTP/1.1\r\nHost example.com\r\n\r\n",
             // Non-numeric Content-Length
             "POST /submit HTTP/1.1\r\nHost: example.com\r\nContent-Length: abc\r\n\r\nHello World",
+            // Trailing garbage in Content-Length
+            "POST /submit HTTP/1.1\r\nHost: example.com\r\nContent-Length: 11x\r\n\r\nHello World",
         };
 
         auto escape = [](std::string_view sv) {
@@ -0,0 +1,52 @@
+#include <boost/ut.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include "http/scan.h"
+
+namespace {
+using namespace boost::ut;
+using namespace http;
+
+constexpr scan::char_set letters{"abcdefghijklmnopqrstuvwxyz"};
+
+suite<"http scan"> _ = []{
+    "char set"_test = [] {
+        expect(letters.contains('a') && letters.contains('z'));
+        expect(!letters.contains('A') && !letters.contains('0'));
+        expect(!letters.contains(static_cast<char>(0xe1)));
+    };
+
+    "crlf"_test = [] {
+        expect(scan::find_crlf("abc\r\n") == 3_u);
+        expect(scan::find_crlf("a\rb\r\n") == 3_u);
+        expect(scan::find_crlf("abc\r") == std::string_view::npos);
+        expect(scan::find_crlf("") == std::string_view::npos);
+        expect(scan::find_crlf(std::string(100, 'x') + "\r\n") == 100_u);
+    };
+
+    "kernels agree with scalar"_test = [] {
+        std::mt19937 rng{42};
+        const auto& reference = scan::kernels_for(scan::isa::scalar);
+        for (auto level : {scan::isa::sse42, scan::isa::avx2}) {
+            if (!scan::supported(level)) {
+                continue;
+            }
+            const auto& k = scan::kernels_for(level);
+            for (size_t round = 0; round < 2000; ++round) {
+                // mostly letters, so the runs cross several vector widths
+                std::string buffer(rng() % 200, 'a');
+                for (auto& c : buffer) {
+                    c = rng() % 40 == 0 ? static_cast<char>(rng() % 256) : static_cast<char>('a' + rng() % 26);
+                }
+                const char* first = buffer.data();
+                const char* last = buffer.data() + buffer.size();
+                char needle = static_cast<char>('a' + rng() % 26);
+
+                expect(k.find_byte(first, last, needle) == reference.find_byte(first, last, needle));
+                expect(k.skip(first, last, letters) == reference.skip(first, last, letters));
+            }
+        }
+    };
+};
+}
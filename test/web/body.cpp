@@ -0,0 +1,149 @@
+#include "web/body.h"
+
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace {
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+// What the socket gives on each read, a read past the end fails like a
+// closed connection
+std::deque<std::string> reads;
+
+coro::awaitable_task<int32_t> scripted_read(int32_t, std::span<char> buffer) {
+    if (reads.empty()) {
+        co_return 0;
+    }
+    auto& next = reads.front();
+    size_t size = std::min(next.size(), buffer.size());
+    next.copy(buffer.data(), size);
+    next.erase(0, size);
+    if (next.empty()) {
+        reads.pop_front();
+    }
+    co_return static_cast<int32_t>(size);
+}
+
+// A connection that has read `first` into its current buffer and parsed
+// the head of a request with a streamed body out of it
+struct connection {
+    explicit connection(std::string_view first, std::initializer_list<std::string> later = {}) {
+        reads.assign(later.begin(), later.end());
+        auto buffer = this->buffers.get(this->buffers.current);
+        first.copy(buffer.data(), first.size());
+        this->unparsed = {buffer.data(), first.size()};
+        this->unparsed.remove_prefix(this->parser.feed(this->unparsed));
+        this->head = std::move(this->parser.pop_front().value());
+    }
+
+    web::body_stream stream() {
+        return {this->parser, this->buffers, this->unparsed, -1, 1s, scripted_read};
+    }
+
+    http::request::parser parser{{}, http::request::body_mode::stream};
+    web::read_buffers     buffers{};
+    std::string_view      unparsed{};
+    http::request::msg    head{};
+};
+
+std::string read_all(web::body_stream& body) {
+    std::string out;
+    for (auto piece = coro::sync_wait(body.next()); !piece.empty(); piece = coro::sync_wait(body.next())) {
+        out += piece;
+    }
+    return out;
+}
+
+bool points_into(std::string_view piece, std::span<char> buffer) {
+    return piece.data() >= buffer.data() && piece.data() + piece.size() <= buffer.data() + buffer.size();
+}
+
+suite<"web body stream"> _ = []{
+    "collect within the limit"_test = [] {
+        connection conn{"POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\nHello World"};
+        expect(conn.head.body_follows);
+        auto body = conn.stream();
+        expect(!body.done() && !body.failed());
+
+        std::string out;
+        auto whole = coro::sync_wait(body.collect(out, 64));
+        expect(whole == std::optional<std::string_view>{"Hello World"});
+        // it came in one piece, so nothing was copied
+        expect(points_into(*whole, conn.buffers.get(0)));
+        expect(body.done() && !body.failed());
+        expect(conn.buffers.current == 0_u);
+    };
+
+    "collect across reads"_test = [] {
+        connection conn{
+            "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nHel",
+            {"lo\r\n6\r\n Wor", "ld\r\n0\r\nChecksum: abc\r\n\r\nGET /next HTTP/1.1\r\n\r\n"}
+        };
+        auto body = conn.stream();
+        std::string out;
+        auto whole = coro::sync_wait(body.collect(out, 64));
+        expect(whole == std::optional<std::string_view>{"Hello World"});
+        expect(body.done() && !body.failed());
+        expect(body.trailers()["Checksum"] == "abc");
+
+        // the head of the body's request is still intact in the other one
+        expect(conn.buffers.current == 1_u);
+        expect(conn.unparsed == "GET /next HTTP/1.1\r\n\r\n");
+        expect(points_into(conn.unparsed, conn.buffers.get(1)));
+        expect(conn.head.header["Transfer-Encoding"] == "chunked");
+    };
+
+    "collect over the limit"_test = [] {
+        connection conn{"POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\nHel", {"lo W", "orld"}};
+        auto body = conn.stream();
+        std::string out;
+        expect(!coro::sync_wait(body.collect(out, 4)).has_value());
+        expect(!body.done() && !body.failed());
+
+        // what was collected comes first, then the rest
+        expect(read_all(body) == "Hello World");
+        expect(body.done() && !body.failed());
+        expect(coro::sync_wait(body.drain()));
+    };
+
+    "read in small steps"_test = [] {
+        connection conn{"POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\n", {"Hello World"}};
+        auto body = conn.stream();
+        std::string out;
+        char buffer[3];
+        while (auto size = coro::sync_wait(body.read(buffer))) {
+            out.append(buffer, size);
+        }
+        expect(out == "Hello World");
+        expect(body.done());
+    };
+
+    "malformed chunked body"_test = [] {
+        connection conn{"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabc\r\n"};
+        auto body = conn.stream();
+        std::string out;
+        expect(!coro::sync_wait(body.collect(out, 64)).has_value());
+        expect(body.failed() && body.done());
+        expect(!coro::sync_wait(body.drain()));
+        expect(!conn.parser.pop_front().has_value());
+    };
+
+    "connection closed mid body"_test = [] {
+        connection conn{"POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\nHello", {" W"}};
+        auto body = conn.stream();
+        expect(read_all(body) == "Hello W");
+        expect(body.failed() && !body.done());
+        expect(!coro::sync_wait(body.drain()));
+    };
+};
+
+}
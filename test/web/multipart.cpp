@@ -0,0 +1,142 @@
+#include "web/multipart.h"
+
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+using namespace boost::ut;
+
+constexpr std::string_view boundary = "XyZ";
+
+constexpr std::string_view raw_form =
+    "--XyZ\r\n"
+    "Content-Disposition: form-data; name=\"field\"\r\n"
+    "\r\n"
+    "value\r\n"
+    "--XyZ\r\n"
+    "Content-Disposition: form-data; name=\"upload\"; filename=\"a.txt\"\r\n"
+    "Content-Type: text/plain\r\n"
+    "\r\n"
+    "hello world\r\n"
+    "--XyZ--\r\n";
+
+struct collected {
+    std::string name;
+    std::string filename;
+    std::string body;
+};
+
+// Every part read to its end, or skipped unread when `skip` says so
+coro::awaitable_task<std::vector<collected>> read_all(web::multipart_reader& form, std::vector<bool> skip = {}) {
+    std::vector<collected> parts;
+    while (auto* part = co_await form.next_part()) {
+        auto& out = parts.emplace_back(std::string{part->name}, std::string{part->filename.value_or("")});
+        if (parts.size() <= skip.size() && skip[parts.size() - 1]) {
+            continue;
+        }
+        for (auto piece = co_await form.read(); !piece.empty(); piece = co_await form.read()) {
+            out.body += piece;
+        }
+    }
+    co_return parts;
+}
+
+// What io::awaiter::write gives back, without the ring
+struct written {
+    int32_t n;
+    bool await_ready() { return true; }
+    void await_suspend(std::coroutine_handle<>) {}
+    int32_t await_resume() { return this->n; }
+};
+
+// Takes at most `limit` bytes per write, like a file on a full disk or a
+// pipe would
+struct sink {
+    std::string data{};
+    size_t      limit{SIZE_MAX};
+    bool        fail{false};
+
+    written operator()(const char* ptr, uint32_t size, size_t offset) {
+        if (this->fail || offset != this->data.size()) {
+            return {-1};
+        }
+        size = static_cast<uint32_t>(std::min<size_t>(size, this->limit));
+        this->data.append(ptr, size);
+        return {static_cast<int32_t>(size)};
+    }
+};
+
+coro::awaitable_task<std::optional<size_t>> save_file(web::multipart_reader& form, sink& out) {
+    while (auto* part = co_await form.next_part()) {
+        if (part->is_file()) {
+            co_return co_await form.save([&out](const char* ptr, uint32_t size, size_t offset) {
+                return out(ptr, size, offset);
+            });
+        }
+    }
+    co_return std::nullopt;
+}
+
+suite<"web multipart reader"> _ = []{
+    "buffered body"_test = [] {
+        web::multipart_reader form{boundary, nullptr, raw_form};
+        auto parts = coro::sync_wait(read_all(form));
+        expect(parts.size() == 2_u);
+        expect(parts[0].name == "field" && parts[0].filename.empty() && parts[0].body == "value");
+        expect(parts[1].name == "upload" && parts[1].filename == "a.txt" && parts[1].body == "hello world");
+        expect(!form.failed());
+    };
+
+    "part skipped unread"_test = [] {
+        web::multipart_reader form{boundary, nullptr, raw_form};
+        auto parts = coro::sync_wait(read_all(form, {true}));
+        expect(parts.size() == 2_u);
+        expect(parts[0].name == "field" && parts[0].body.empty());
+        expect(parts[1].name == "upload" && parts[1].body == "hello world");
+        expect(!form.failed());
+    };
+
+    "truncated body"_test = [] {
+        // in the middle of the last part, and right before the closing boundary
+        for (size_t cut : {raw_form.size() - 20, raw_form.size() - 9}) {
+            web::multipart_reader form{boundary, nullptr, raw_form.substr(0, cut)};
+            auto parts = coro::sync_wait(read_all(form));
+            expect(parts.size() == 2_u);
+            expect(parts[0].body == "value");
+            expect(form.failed()) << cut;
+        }
+
+        web::multipart_reader form{boundary, nullptr, raw_form.substr(0, 10)};
+        expect(coro::sync_wait(read_all(form)).empty());
+        expect(form.failed());
+    };
+
+    "save"_test = [] {
+        for (size_t limit : {1uz, 3uz, SIZE_MAX}) {
+            web::multipart_reader form{boundary, nullptr, raw_form};
+            sink out{.limit = limit};
+            auto saved = coro::sync_wait(save_file(form, out));
+            expect(saved == std::optional<size_t>{11}) << limit;
+            expect(out.data == "hello world");
+        }
+
+        web::multipart_reader failing{boundary, nullptr, raw_form};
+        sink out{.fail = true};
+        expect(!coro::sync_wait(save_file(failing, out)).has_value());
+
+        web::multipart_reader truncated{boundary, nullptr, raw_form.substr(0, raw_form.size() - 9)};
+        sink partial{};
+        expect(!coro::sync_wait(save_file(truncated, partial)).has_value());
+        expect(truncated.failed());
+    };
+};
+
+}
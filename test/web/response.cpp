@@ -0,0 +1,108 @@
+#include "web/response.h"
+
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace boost::ut;
+
+iovec entry(std::string& str) {
+    return {str.data(), str.size()};
+}
+
+// Writes `iov` to `sink` at most `limit` bytes per call, like a socket
+// that keeps accepting part of a writev
+void write_all(std::span<iovec> iov, std::string& sink, size_t limit) {
+    while (!iov.empty()) {
+        size_t written = 0;
+        for (const auto& v : iov) {
+            size_t size = std::min(v.iov_len, limit - written);
+            sink.append(static_cast<const char*>(v.iov_base), size);
+            written += size;
+        }
+        iov = web::response::consume(iov, written);
+    }
+}
+
+suite<"response writes"> _ = []{
+    "consume"_test = []{
+        std::string a = "abc", b = "defg", empty{};
+
+        // ends mid-iovec
+        std::vector<iovec> iov{entry(a), entry(b)};
+        auto rest = web::response::consume(iov, 2);
+        expect(rest.size() == 2_u);
+        expect(rest[0].iov_len == 1_u && static_cast<char*>(rest[0].iov_base) == a.data() + 2);
+
+        // ends on an iovec boundary
+        iov = {entry(a), entry(b)};
+        rest = web::response::consume(iov, 3);
+        expect(rest.size() == 1_u);
+        expect(rest[0].iov_base == b.data() && rest[0].iov_len == 4_u);
+
+        // empty entries ahead of, between and behind the written bytes
+        iov = {entry(empty), entry(a), entry(empty), entry(b), entry(empty)};
+        rest = web::response::consume(iov, 3);
+        expect(rest.size() == 2_u);
+        expect(rest[0].iov_base == b.data());
+        rest = web::response::consume(rest, 4);
+        expect(rest.empty());
+
+        iov = {entry(empty), entry(a)};
+        rest = web::response::consume(iov, 1);
+        expect(rest.size() == 1_u);
+        expect(rest[0].iov_len == 2_u && static_cast<char*>(rest[0].iov_base) == a.data() + 1);
+    };
+
+    "partial writes"_test = []{
+        std::string empty{}, a = "GET ", b = "/index", c = ".html";
+        std::string expected = a + b + c;
+        for (size_t limit = 1; limit <= expected.size(); ++limit) {
+            std::vector<iovec> iov{entry(empty), entry(a), entry(empty), entry(b), entry(c)};
+            std::string sink;
+            write_all(iov, sink, limit);
+            expect(sink == expected) << limit;
+        }
+    };
+
+    "batch keeps request order"_test = []{
+        using web::response::batch;
+        std::vector<std::pair<std::string, std::vector<std::byte>>> responses;
+        for (size_t size : {10uz, batch::max_copied_body + 1, 20uz, 30uz, 4 * batch::max_copied_body, 0uz, 5uz}) {
+            std::vector<std::byte> body(size);
+            for (size_t i = 0; i < size; ++i) {
+                body[i] = static_cast<std::byte>('a' + (responses.size() + i) % 26);
+            }
+            responses.emplace_back(std::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n", size), std::move(body));
+        }
+
+        std::string expected;
+        for (const auto& [header, body] : responses) {
+            expected += header;
+            expected.append(reinterpret_cast<const char*>(body.data()), body.size());
+        }
+
+        for (size_t limit : {7uz, 4096uz, expected.size()}) {
+            batch out;
+            std::string sink;
+            for (const auto& [header, body] : responses) {
+                iovec iov[3];
+                auto pending = out.gather(header, body, iov);
+                if (!pending.empty()) {
+                    write_all(pending, sink, limit);
+                    out.clear();
+                }
+            }
+            iovec rest[1] = {{out.data().data(), out.size()}};
+            write_all(rest, sink, limit);
+            expect(sink == expected) << limit;
+        }
+    };
+};
+
+}